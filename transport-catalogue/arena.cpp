@@ -0,0 +1,71 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace memory {
+
+Arena::Arena(size_t block_size)
+: block_size_(block_size)
+{}
+
+Arena::Arena(Arena&& other) noexcept
+: blocks_(std::move(other.blocks_))
+, current_(std::exchange(other.current_, nullptr))
+, left_(std::exchange(other.left_, 0))
+, block_size_(other.block_size_)
+{
+    other.blocks_.clear();
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        other.blocks_.clear();
+        current_ = std::exchange(other.current_, nullptr);
+        left_ = std::exchange(other.left_, 0);
+        block_size_ = other.block_size_;
+    }
+    return *this;
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+    if (current_ == nullptr || padding + size > left_) {
+        AddBlock(size + alignment);
+        padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+    }
+    std::byte* result = current_ + padding;
+    current_ = result + size;
+    left_ -= padding + size;
+    return result;
+}
+
+std::string_view Arena::CopyString(std::string_view str) {
+    if (str.empty()) {
+        return {};
+    }
+    char* data = static_cast<char*>(Allocate(str.size(), alignof(char)));
+    std::memcpy(data, str.data(), str.size());
+    return {data, str.size()};
+}
+
+Usage Arena::GetMemoryUsage() const {
+    Usage usage{GetHeapBytes(blocks_), blocks_.size()};
+    for (const Block& block : blocks_) {
+        usage.bytes += block.size;
+    }
+    return usage;
+}
+
+void Arena::AddBlock(size_t min_size) {
+    //Слишком большие запросы получают отдельный блок своего размера
+    const size_t size = std::max(block_size_, min_size);
+    blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});
+    current_ = blocks_.back().data.get();
+    left_ = size;
+}
+
+} // namespace memory
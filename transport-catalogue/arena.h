@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "memory_usage.h"
+
+namespace memory {
+
+/*
+ * Арена с последовательным ("bump") выделением памяти крупными блоками.
+ * Адреса выделенных объектов не меняются до уничтожения арены, поэтому
+ * на них можно ссылаться через указатели и string_view.
+ * Деструкторы размещённых объектов не вызываются: арена освобождает
+ * блоки целиком, поэтому в ней можно хранить только тривиально разрушаемые типы.
+ */
+class Arena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    // Блоки переходят к новой арене, а исходная остаётся пустой и пригодной для выделений
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+
+    // Выделяет неинициализированную память заданного размера и выравнивания
+    void* Allocate(size_t size, size_t alignment);
+
+    template <typename T, typename... Args>
+    T* Create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena never calls destructors");
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Копирует элементы диапазона в один непрерывный участок арены
+    template <typename It>
+    auto CopyRange(It begin, It end) {
+        using T = typename std::iterator_traits<It>::value_type;
+        static_assert(std::is_trivially_destructible_v<T>, "Arena never calls destructors");
+        const size_t count = static_cast<size_t>(std::distance(begin, end));
+        T* data = count ? static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))) : nullptr;
+        std::uninitialized_copy(begin, end, data);
+        return std::span<const T>(data, count);
+    }
+
+    std::string_view CopyString(std::string_view str);
+
+    // Выделенные блоки целиком, включая ещё не занятый остаток; элементы — блоки
+    Usage GetMemoryUsage() const;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    std::vector<Block> blocks_;
+    std::byte* current_ = nullptr;
+    size_t left_ = 0;
+    size_t block_size_;
+
+    void AddBlock(size_t min_size);
+};
+
+} // namespace memory
@@ -0,0 +1,120 @@
+#include "bus_incidence.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace incidence {
+
+BusIncidence::BusIncidence(const std::deque<const Stop*>& stops, std::vector<const Bus*> buses)
+: buses_(std::move(buses))
+{
+    std::sort(buses_.begin(), buses_.end(), [](const Bus* lhs, const Bus* rhs) {
+        return lhs->name < rhs->name;
+    });
+    stop_ids_.reserve(stops.size());
+    for (const Stop* stop : stops) {
+        stop_ids_.emplace(stop->name, static_cast<uint32_t>(stop_ids_.size()));
+    }
+
+    //Тройки (остановка, маршрут, позиция), сгруппированные по остановке и маршруту
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> positions;
+    for (uint32_t bus = 0; bus < buses_.size(); ++bus) {
+        const std::span<const std::string_view> bus_stops = buses_[bus]->stops;
+        for (uint32_t position = 0; position < bus_stops.size(); ++position) {
+            positions.emplace_back(stop_ids_.at(bus_stops[position]), bus, position);
+        }
+    }
+    std::sort(positions.begin(), positions.end());
+
+    stop_begins_.assign(stop_ids_.size() + 1, 0);
+    for (size_t i = 0; i < positions.size();) {
+        const auto [stop, bus, first] = positions[i];
+        size_t last = i;
+        while (last + 1 < positions.size() && std::get<0>(positions[last + 1]) == stop
+               && std::get<1>(positions[last + 1]) == bus) {
+            ++last;
+        }
+        stop_buses_.push_back({bus, first, std::get<2>(positions[last])});
+        ++stop_begins_[stop + 1];
+        i = last + 1;
+    }
+    for (size_t i = 1; i < stop_begins_.size(); ++i) {
+        stop_begins_[i] += stop_begins_[i - 1];
+    }
+}
+
+void BusIncidence::AddStops(std::span<const Stop* const> stops) {
+    for (const Stop* stop : stops) {
+        stop_ids_.emplace(stop->name, static_cast<uint32_t>(stop_ids_.size()));
+        stop_begins_.push_back(stop_begins_.back());
+    }
+}
+
+void BusIncidence::ReplaceBuses(std::span<const Bus* const> buses) {
+    for (const Bus* bus : buses) {
+        const auto it = std::lower_bound(buses_.begin(), buses_.end(), bus->name, [](const Bus* lhs, std::string_view name) {
+            return lhs->name < name;
+        });
+        if (it != buses_.end() && (*it)->name == bus->name) {
+            *it = bus;
+        }
+    }
+}
+
+std::optional<std::vector<const Bus*>> BusIncidence::GetBuses(std::string_view stop_name) const {
+    const std::optional<std::span<const StopOnBus>> stop_buses = GetStopBuses(stop_name);
+    if (!stop_buses) {
+        return std::nullopt;
+    }
+    std::vector<const Bus*> result;
+    for (const StopOnBus& stop_on_bus : *stop_buses) {
+        result.push_back(buses_[stop_on_bus.bus]);
+    }
+    return result;
+}
+
+std::optional<std::vector<const Bus*>> BusIncidence::FindDirectBuses(std::string_view from, std::string_view to) const {
+    const std::optional<std::span<const StopOnBus>> from_stop_buses = GetStopBuses(from);
+    const std::optional<std::span<const StopOnBus>> to_stop_buses = GetStopBuses(to);
+    if (!from_stop_buses || !to_stop_buses) {
+        return std::nullopt;
+    }
+    const std::span<const StopOnBus> from_buses = *from_stop_buses;
+    const std::span<const StopOnBus> to_buses = *to_stop_buses;
+    std::vector<const Bus*> result;
+    auto from_it = from_buses.begin();
+    auto to_it = to_buses.begin();
+    while (from_it != from_buses.end() && to_it != to_buses.end()) {
+        if (from_it->bus < to_it->bus) {
+            ++from_it;
+        } else if (to_it->bus < from_it->bus) {
+            ++to_it;
+        } else {
+            //Доехать можно, если from хотя бы раз встречается в маршруте раньше to
+            if (from_it->first < to_it->last) {
+                result.push_back(buses_[from_it->bus]);
+            }
+            ++from_it;
+            ++to_it;
+        }
+    }
+    return result;
+}
+
+memory::Usage BusIncidence::GetMemoryUsage() const {
+    return {
+        memory::GetHeapBytes(buses_) + memory::GetHeapBytes(stop_ids_)
+            + memory::GetHeapBytes(stop_begins_) + memory::GetHeapBytes(stop_buses_),
+        stop_buses_.size()
+    };
+}
+
+std::optional<std::span<const BusIncidence::StopOnBus>> BusIncidence::GetStopBuses(std::string_view stop_name) const {
+    const auto it = stop_ids_.find(stop_name);
+    if (it == stop_ids_.end()) {
+        return std::nullopt;
+    }
+    return std::span(stop_buses_).subspan(stop_begins_[it->second], stop_begins_[it->second + 1] - stop_begins_[it->second]);
+}
+
+} // namespace incidence
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "domain.h"
+#include "memory_usage.h"
+
+namespace incidence {
+
+/*
+ * Статическая таблица «остановка — маршрут». Маршруты пронумерованы в порядке имён.
+ * Для каждой остановки хранится отсортированный массив номеров проходящих через неё
+ * маршрутов вместе с первой и последней позицией остановки в списке маршрута;
+ * массивы всех остановок упакованы подряд. Номера сразу дают имена по алфавиту,
+ * а маршруты, общие для двух остановок, находятся слиянием двух коротких массивов.
+ */
+class BusIncidence {
+public:
+    BusIncidence() = default;
+    BusIncidence(const std::deque<const Stop*>& stops, std::vector<const Bus*> buses);
+
+    // Добавляет остановки, через которые пока не проходит ни один маршрут
+    void AddStops(std::span<const Stop* const> stops);
+    // Заменяет записи маршрутов на новые с теми же именами и списками остановок
+    void ReplaceBuses(std::span<const Bus* const> buses);
+
+    // Маршруты через остановку в порядке имён; nullopt, если остановки нет
+    std::optional<std::vector<const Bus*>> GetBuses(std::string_view stop_name) const;
+    // Маршруты, по которым от from можно доехать до to без пересадки, в порядке имён;
+    // nullopt, если какой-то из остановок нет
+    std::optional<std::vector<const Bus*>> FindDirectBuses(std::string_view from, std::string_view to) const;
+
+    memory::Usage GetMemoryUsage() const;
+
+private:
+    struct StopOnBus {
+        uint32_t bus = 0;
+        // Позиции остановки в списке остановок маршрута
+        uint32_t first = 0;
+        uint32_t last = 0;
+    };
+
+    std::vector<const Bus*> buses_;
+    std::unordered_map<std::string_view, uint32_t> stop_ids_;
+    // Начала диапазонов stop_buses_ для каждой остановки и конец последнего
+    std::vector<uint32_t> stop_begins_ = {0};
+    std::vector<StopOnBus> stop_buses_;
+
+    std::optional<std::span<const StopOnBus>> GetStopBuses(std::string_view stop_name) const;
+};
+
+} // namespace incidence
@@ -0,0 +1,87 @@
+#include "catalogue_version.h"
+
+#include <sstream>
+#include <utility>
+
+#include "request_handler.h"
+
+using namespace std::literals;
+
+namespace {
+
+memory::Report MakeMapReport(const svg::Document& map) {
+    return {{{"document"s, map.GetMemoryUsage()}}};
+}
+
+std::string RenderToString(const svg::Document& map) {
+    std::ostringstream out;
+    map.Render(out);
+    return std::move(out).str();
+}
+
+routing::TransportRouter MakeRouter(const TransportCatalogue& db, const routing::RoutingSettings& routing_settings,
+                                    const std::optional<std::string>& router_cache) {
+    return router_cache
+        ? routing::TransportRouter(db, routing_settings, *router_cache)
+        : routing::TransportRouter(db, routing_settings);
+}
+
+} // namespace
+
+memory::Reports MakeMemoryReports(const TransportCatalogue& db, const routing::TransportRouter& transport_router,
+                                  memory::Usage document_usage, const svg::Document& map) {
+    return {
+        {"catalogue"s, db.GetMemoryUsage()},
+        {"router"s, transport_router.GetMemoryUsage()},
+        {"json"s, {{{"document"s, document_usage}}}},
+        {"map"s, MakeMapReport(map)}
+    };
+}
+
+CatalogueVersion::CatalogueVersion(TransportCatalogue source, const routing::RoutingSettings& routing_settings,
+                                   const std::optional<std::string>& router_cache, renderer::MapRenderer& renderer,
+                                   memory::Usage document_usage)
+: db(std::move(source))
+, router(MakeRouter(db, routing_settings, router_cache))
+{
+    const svg::Document map_document = StatRequestHandler(db, renderer).RenderMap();
+    map = RenderToString(map_document);
+    memory_reports = MakeMemoryReports(db, router, document_usage, map_document);
+}
+
+CatalogueVersion::CatalogueVersion(const CatalogueVersion& previous, const CatalogueData& delta, renderer::MapRenderer& renderer)
+: db(previous.db)
+, router(db, previous.router)
+, map(previous.map)
+, memory_reports(previous.memory_reports)
+{
+    const CatalogueChanges changes = db.Update(delta);
+    router.Update(changes);
+    //На карте только маршруты и их остановки. Новый маршрут может сдвинуть границы карты
+    //и цвета следующих по алфавиту маршрутов, поэтому она рисуется заново целиком,
+    //а без новых маршрутов не меняется
+    if (!changes.added_buses.empty()) {
+        RenderMap(renderer);
+    }
+    UpdateMemoryReports();
+}
+
+void CatalogueVersion::RenderMap(renderer::MapRenderer& renderer) {
+    const svg::Document map_document = StatRequestHandler(db, renderer).RenderMap();
+    map = RenderToString(map_document);
+    for (auto& [name, report] : memory_reports) {
+        if (name == "map"sv) {
+            report = MakeMapReport(map_document);
+        }
+    }
+}
+
+void CatalogueVersion::UpdateMemoryReports() {
+    for (auto& [name, report] : memory_reports) {
+        if (name == "catalogue"sv) {
+            report = db.GetMemoryUsage();
+        } else if (name == "router"sv) {
+            report = router.GetMemoryUsage();
+        }
+    }
+}
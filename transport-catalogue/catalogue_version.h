@@ -0,0 +1,52 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "domain.h"
+#include "map_renderer.h"
+#include "memory_usage.h"
+#include "svg.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+#include "versioned.h"
+
+//Память основных структур: пишется в журнал при запуске и выдаётся по запросу Stats.
+//document_usage — память разобранного входного документа
+memory::Reports MakeMemoryReports(const TransportCatalogue& db, const routing::TransportRouter& transport_router,
+                                  memory::Usage document_usage, const svg::Document& map);
+
+/*
+ * Версия данных, по которой отвечают запросы: справочник, маршрутизатор по нему,
+ * отрисованная карта и отчёт о памяти. Версии публикуются через versioning::Versioned
+ * и после публикации не меняются. Следующая версия строится рядом с текущей и разделяет
+ * с ней записи справочника, а запросы, начатые до публикации, дочитывают свою версию.
+ */
+struct CatalogueVersion {
+    //Первая версия: справочник source и маршрутизатор по нему — с файлом-кэшем
+    //таблицы маршрутов, если задан router_cache
+    CatalogueVersion(TransportCatalogue source, const routing::RoutingSettings& routing_settings,
+                     const std::optional<std::string>& router_cache, renderer::MapRenderer& renderer,
+                     memory::Usage document_usage);
+    //Следующая версия: previous, дополненная пакетом delta. Индексы справочника, граф
+    //и таблица маршрутов копируются и дополняются, карта рисуется заново, только если
+    //появились новые маршруты. Ошибки TransportCatalogue::Update пробрасываются
+    CatalogueVersion(const CatalogueVersion& previous, const CatalogueData& delta, renderer::MapRenderer& renderer);
+
+    CatalogueVersion(const CatalogueVersion&) = delete;
+    CatalogueVersion& operator=(const CatalogueVersion&) = delete;
+
+    TransportCatalogue db;
+    //Ссылается на db
+    routing::TransportRouter router;
+    std::string map;
+    memory::Reports memory_reports;
+
+private:
+    //Отрисовывает карту по db и обновляет её отчёт о памяти
+    void RenderMap(renderer::MapRenderer& renderer);
+    //Обновляет отчёты справочника и маршрутизатора
+    void UpdateMemoryReports();
+};
+
+using CatalogueVersions = versioning::Versioned<CatalogueVersion>;
@@ -1,23 +1,49 @@
 #pragma once
 
-#include <string>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include "geo.h"
 
 
+//Записи справочника хранятся в арене, поэтому ссылаются на имена и списки остановок
+//без владения. Входные данные для AddStop/AddBus должны жить только на время вызова.
 struct Stop {
-	std::string name;
+	std::string_view name;
 	geo::Coordinates coordinates;
+	//Заполняется справочником при добавлении остановки
+	geo::SpherePoint position;
 };
 
 struct Bus {
-	std::string name;
-	std::vector<std::string_view> stops;
+	std::string_view name;
+	std::span<const std::string_view> stops;
 	int route_length = 0;
 	bool is_circle = false;
 };
 
+struct Distance {
+	std::string_view from;
+	std::string_view to;
+	int distance = 0;
+};
+
+//Все базовые запросы сразу — для пакетной загрузки справочника (TransportCatalogue::Load)
+struct CatalogueData {
+	std::vector<Stop> stops;
+	std::vector<Distance> distances;
+	std::vector<Bus> buses;
+};
+
+//Что изменилось в справочнике после применения пакета изменений (TransportCatalogue::Update)
+struct CatalogueChanges {
+	std::vector<const Stop*> added_stops;
+	std::vector<const Bus*> added_buses;
+	//Существующие маршруты, длина которых изменилась из-за новых расстояний
+	std::vector<const Bus*> changed_buses;
+};
+
 struct BusInfo {
 	size_t stops_on_route = 0;
 	size_t unique_stops = 0;
@@ -1,6 +1,8 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 
 namespace geo {
@@ -17,7 +19,31 @@ double ComputeDistance(Coordinates from, Coordinates to) {
     const double dr = M_PI / 180.0;
     return acos(sin(from.lat * dr) * sin(to.lat * dr)
                 + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
-        * 6371000;
+        * EARTH_RADIUS;
+}
+
+SpherePoint ToSpherePoint(Coordinates coords) {
+    using namespace std;
+    const double dr = M_PI / 180.0;
+    const double cos_lat = cos(coords.lat * dr);
+    return {cos_lat * cos(coords.lng * dr), cos_lat * sin(coords.lng * dr), sin(coords.lat * dr)};
+}
+
+double ComputeDistance(const SpherePoint& from, const SpherePoint& to) {
+    // Из-за погрешностей скалярное произведение может чуть выйти за [-1, 1]
+    const double dot = std::clamp(from.x * to.x + from.y * to.y + from.z * to.z, -1.0, 1.0);
+    return std::acos(dot) * EARTH_RADIUS;
+}
+
+void ComputeDistances(std::span<const SpherePoint> from, std::span<const SpherePoint> to, std::span<double> distances) {
+    assert(from.size() == to.size() && from.size() == distances.size());
+    const size_t count = distances.size();
+    for (size_t i = 0; i < count; ++i) {
+        distances[i] = std::clamp(from[i].x * to[i].x + from[i].y * to[i].y + from[i].z * to[i].z, -1.0, 1.0);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        distances[i] = std::acos(distances[i]) * EARTH_RADIUS;
+    }
 }
 
 }  // namespace geo
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <cmath>
+#include <span>
 
 namespace geo {
+
+inline constexpr double EARTH_RADIUS = 6371000;
+
 struct Coordinates {
     double lat;
     double lng;
@@ -10,6 +14,20 @@ struct Coordinates {
     bool operator!=(const Coordinates& other) const;
 };
 
+// Точка на единичной сфере. Тригонометрия считается один раз при создании,
+// после чего расстояние между точками сводится к скалярному произведению и acos
+struct SpherePoint {
+    double x = 0;
+    double y = 0;
+    double z = 0;
+};
+
+SpherePoint ToSpherePoint(Coordinates coords);
+
 double ComputeDistance(Coordinates from, Coordinates to);
+double ComputeDistance(const SpherePoint& from, const SpherePoint& to);
+// Пакетный вариант: distances[i] — расстояние между from[i] и to[i].
+// Циклы без ветвлений, чтобы компилятор мог их векторизовать
+void ComputeDistances(std::span<const SpherePoint> from, std::span<const SpherePoint> to, std::span<double> distances);
 
 }
\ No newline at end of file
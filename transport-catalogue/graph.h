@@ -1,5 +1,6 @@
 #pragma once
 
+#include "memory_usage.h"
 #include "ranges.h"
 
 #include <cstdlib>
@@ -27,11 +28,14 @@ public:
     DirectedWeightedGraph() = default;
     explicit DirectedWeightedGraph(size_t vertex_count);
     EdgeId AddEdge(const Edge<Weight>& edge);
+    VertexId AddVertex();
+    void SetWeight(EdgeId edge_id, Weight weight);
 
     size_t GetVertexCount() const;
     size_t GetEdgeCount() const;
     const Edge<Weight>& GetEdge(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+    memory::Report GetMemoryUsage() const;
 
 private:
     std::vector<Edge<Weight>> edges_;
@@ -51,6 +55,17 @@ EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
     return id;
 }
 
+template <typename Weight>
+VertexId DirectedWeightedGraph<Weight>::AddVertex() {
+    incidence_lists_.emplace_back();
+    return incidence_lists_.size() - 1;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::SetWeight(EdgeId edge_id, Weight weight) {
+    edges_.at(edge_id).weight = weight;
+}
+
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
     return incidence_lists_.size();
@@ -71,4 +86,16 @@ typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
+
+template <typename Weight>
+memory::Report DirectedWeightedGraph<Weight>::GetMemoryUsage() const {
+    memory::Report report;
+    report.Add("edges", {memory::GetHeapBytes(edges_), edges_.size()});
+    memory::Usage incidence{memory::GetHeapBytes(incidence_lists_), incidence_lists_.size()};
+    for (const IncidenceList& list : incidence_lists_) {
+        incidence.bytes += memory::GetHeapBytes(list);
+    }
+    report.Add("incidence_lists", incidence);
+    return report;
+}
 }  // namespace graph
\ No newline at end of file
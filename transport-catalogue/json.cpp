@@ -1,49 +1,300 @@
 #include "json.h"
 
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <iterator>
+#include <limits>
+#include <locale>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace json {
 
 namespace {
 using namespace std::literals;
 
-Node LoadNode(std::istream& input);
-Node LoadString(std::istream& input);
+/*
+ * Разбор JSON из непрерывного буфера. Повторяет поведение прежнего разбора из std::istream
+ * (те же узлы и те же ParsingError), но читает символы указателем, без вызовов потока.
+ */
+class Parser {
+public:
+    //handlers — потоковые массивы корневого словаря (см. LoadStreaming)
+    explicit Parser(std::string_view input, const StreamHandlers* handlers = nullptr)
+        : pos_(input.data())
+        , end_(input.data() + input.size())
+        , handlers_(handlers) {
+    }
 
-std::string LoadLiteral(std::istream& input) {
-    std::string s;
-    while (std::isalpha(input.peek())) {
-        s.push_back(static_cast<char>(input.get()));
+    Node LoadNode();
+    // Корень документа: в корневом словаре массивы из handlers_ передаются обработчикам
+    Node LoadDocument();
+
+private:
+    const char* pos_;
+    const char* end_;
+    const StreamHandlers* handlers_;
+    // Пары разбираемых словарей, вложенные — поверх внешних. Готовый словарь
+    // забирает свои пары одним блоком точного размера
+    std::vector<Dict::value_type> dict_items_;
+
+    // Как input >> c: пропускает пробельные символы и читает следующий. false в конце ввода
+    bool ReadChar(char& c);
+    // Следующий символ без сдвига; EOF в конце ввода
+    int Peek() const {
+        return pos_ == end_ ? EOF : static_cast<unsigned char>(*pos_);
     }
-    return s;
+
+    // Элементы массива после открывающей скобки, по одному в on_item
+    template <typename OnItem>
+    void LoadArrayItems(OnItem on_item);
+    Node LoadArray();
+    Node LoadDict(bool is_root = false);
+    // Значение ключа потокового массива: если это массив, его элементы уходят
+    // обработчику, а в документе остаётся пустой массив
+    Node LoadStreamedArray(const StreamHandler& handler);
+    // Строка после открывающей кавычки
+    std::string LoadString();
+    std::string_view LoadLiteral();
+    Node LoadBool();
+    Node LoadNull();
+    Node LoadNumber();
+};
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
 }
 
-Node LoadArray(std::istream& input) {
-    std::vector<Node> result;
+// Символы, на которых прерывается тело строки
+bool IsStringSpecial(char c) {
+    return c == '"' || c == '\\' || c == '\n' || c == '\r';
+}
 
-    for (char c; input >> c && c != ']';) {
-        if (c != ',') {
-            input.putback(c);
+// Символы, которые PrintString экранирует
+bool IsEscaped(char c) {
+    return IsStringSpecial(c) || c == '\t';
+}
+
+/*
+ * Классификация символов блоками по 32 (AVX2) или 16 (SSE2) байт: для блока строится
+ * битовая маска нужных символов, и первый из них — младший установленный бит маски.
+ * Набор инструкций выбирается при сборке; без них и в хвосте буфера символы
+ * проверяются по одному.
+ */
+#if defined(__AVX2__) || defined(__SSE2__)
+#define JSON_SIMD_SCAN
+
+#if defined(__AVX2__)
+using Block = __m256i;
+constexpr ptrdiff_t BLOCK_SIZE = 32;
+constexpr uint32_t FULL_MASK = 0xFFFFFFFFu;
+
+Block LoadBlock(const char* data) {
+    return _mm256_loadu_si256(reinterpret_cast<const Block*>(data));
+}
+Block Splat(char c) {
+    return _mm256_set1_epi8(c);
+}
+Block Equal(Block lhs, Block rhs) {
+    return _mm256_cmpeq_epi8(lhs, rhs);
+}
+Block Or(Block lhs, Block rhs) {
+    return _mm256_or_si256(lhs, rhs);
+}
+Block Subtract(Block lhs, Block rhs) {
+    return _mm256_sub_epi8(lhs, rhs);
+}
+Block MinUnsigned(Block lhs, Block rhs) {
+    return _mm256_min_epu8(lhs, rhs);
+}
+uint32_t ToMask(Block block) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(block));
+}
+#else
+using Block = __m128i;
+constexpr ptrdiff_t BLOCK_SIZE = 16;
+constexpr uint32_t FULL_MASK = 0xFFFFu;
+
+Block LoadBlock(const char* data) {
+    return _mm_loadu_si128(reinterpret_cast<const Block*>(data));
+}
+Block Splat(char c) {
+    return _mm_set1_epi8(c);
+}
+Block Equal(Block lhs, Block rhs) {
+    return _mm_cmpeq_epi8(lhs, rhs);
+}
+Block Or(Block lhs, Block rhs) {
+    return _mm_or_si128(lhs, rhs);
+}
+Block Subtract(Block lhs, Block rhs) {
+    return _mm_sub_epi8(lhs, rhs);
+}
+Block MinUnsigned(Block lhs, Block rhs) {
+    return _mm_min_epu8(lhs, rhs);
+}
+uint32_t ToMask(Block block) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(block));
+}
+#endif
+
+uint32_t StringSpecialMask(Block block) {
+    return ToMask(Or(Or(Equal(block, Splat('"')), Equal(block, Splat('\\'))),
+                     Or(Equal(block, Splat('\n')), Equal(block, Splat('\r')))));
+}
+
+uint32_t EscapedMask(Block block) {
+    return StringSpecialMask(block) | ToMask(Equal(block, Splat('\t')));
+}
+
+uint32_t NonSpaceMask(Block block) {
+    //Коды \t \n \v \f \r идут подряд с 9 по 13: после вычитания 9 они и только они не больше 4
+    const Block shifted = Subtract(block, Splat('\t'));
+    const Block control = Equal(MinUnsigned(shifted, Splat(4)), shifted);
+    return ToMask(Or(Equal(block, Splat(' ')), control)) ^ FULL_MASK;
+}
+#endif
+
+// Первый символ в [begin, end), для которого block_mask ставит бит, а is_match истинна
+template <typename BlockMask, typename IsMatch>
+const char* FindFirst(const char* begin, const char* end, [[maybe_unused]] BlockMask block_mask, IsMatch is_match) {
+#ifdef JSON_SIMD_SCAN
+    for (; end - begin >= BLOCK_SIZE; begin += BLOCK_SIZE) {
+        if (const uint32_t mask = block_mask(LoadBlock(begin))) {
+            return begin + std::countr_zero(mask);
         }
-        result.push_back(LoadNode(input));
     }
-    if (!input) {
-        throw ParsingError("Array parsing error"s);
+#endif
+    while (begin != end && !is_match(*begin)) {
+        ++begin;
+    }
+    return begin;
+}
+
+const char* FindStringSpecial(const char* begin, const char* end) {
+#ifdef JSON_SIMD_SCAN
+    return FindFirst(begin, end, StringSpecialMask, IsStringSpecial);
+#else
+    return FindFirst(begin, end, nullptr, IsStringSpecial);
+#endif
+}
+
+const char* FindEscaped(const char* begin, const char* end) {
+#ifdef JSON_SIMD_SCAN
+    return FindFirst(begin, end, EscapedMask, IsEscaped);
+#else
+    return FindFirst(begin, end, nullptr, IsEscaped);
+#endif
+}
+
+const char* SkipSpaces(const char* begin, const char* end) {
+    auto is_not_space = [](char c) {
+        return !IsSpace(c);
+    };
+#ifdef JSON_SIMD_SCAN
+    return FindFirst(begin, end, NonSpaceMask, is_not_space);
+#else
+    return FindFirst(begin, end, nullptr, is_not_space);
+#endif
+}
+
+bool IsDigit(int c) {
+    return c >= '0' && c <= '9';
+}
+
+bool IsAlpha(int c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool Parser::ReadChar(char& c) {
+    //Чаще всего пробелов перед символом нет совсем
+    if (pos_ != end_ && IsSpace(*pos_)) {
+        pos_ = SkipSpaces(pos_ + 1, end_);
+    }
+    if (pos_ == end_) {
+        return false;
+    }
+    c = *pos_++;
+    return true;
+}
+
+std::string_view Parser::LoadLiteral() {
+    const char* begin = pos_;
+    while (IsAlpha(Peek())) {
+        ++pos_;
+    }
+    return {begin, static_cast<size_t>(pos_ - begin)};
+}
+
+template <typename OnItem>
+void Parser::LoadArrayItems(OnItem on_item) {
+    char c;
+    while (true) {
+        if (!ReadChar(c)) {
+            throw ParsingError("Array parsing error"s);
+        }
+        if (c == ']') {
+            break;
+        }
+        if (c != ',') {
+            --pos_;
+        }
+        on_item(LoadNode());
     }
+}
+
+Node Parser::LoadArray() {
+    std::vector<Node> result;
+    LoadArrayItems([&result](Node item) {
+        result.push_back(std::move(item));
+    });
     return Node(std::move(result));
 }
 
-Node LoadDict(std::istream& input) {
-    Dict dict;
+Node Parser::LoadStreamedArray(const StreamHandler& handler) {
+    if (pos_ != end_ && IsSpace(*pos_)) {
+        pos_ = SkipSpaces(pos_ + 1, end_);
+    }
+    if (Peek() != '[') {
+        return LoadNode();
+    }
+    ++pos_;
+    LoadArrayItems(handler);
+    return Node(Array{});
+}
+
+Node Parser::LoadDict(bool is_root) {
+    const size_t begin = dict_items_.size();
 
-    for (char c; input >> c && c != '}';) {
+    char c;
+    while (true) {
+        if (!ReadChar(c)) {
+            throw ParsingError("Dictionary parsing error"s);
+        }
+        if (c == '}') {
+            break;
+        }
         if (c == '"') {
-            std::string key = LoadString(input).AsString();
-            if (input >> c && c == ':') {
-                if (dict.find(key) != dict.end()) {
-                    throw ParsingError("Duplicate key '"s + key + "' have been found");
+            std::string key = LoadString();
+            if (ReadChar(c) && c == ':') {
+                //Потоковые массивы бывают только в корневом словаре
+                const StreamHandler* handler = nullptr;
+                if (is_root && handlers_ != nullptr) {
+                    if (const auto handler_it = handlers_->find(key); handler_it != handlers_->end()) {
+                        handler = &handler_it->second;
+                    }
                 }
-                dict.emplace(std::move(key), LoadNode(input));
+                Node value = handler ? LoadStreamedArray(*handler) : LoadNode();
+                //Вложенные словари вернут dict_items_ к прежнему размеру, но не к прежнему адресу
+                dict_items_.emplace_back(std::move(key), std::move(value));
             } else {
                 throw ParsingError(": is expected but '"s + c + "' has been found"s);
             }
@@ -51,30 +302,46 @@ Node LoadDict(std::istream& input) {
             throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
         }
     }
-    if (!input) {
-        throw ParsingError("Dictionary parsing error"s);
+    //Пары копятся в порядке ввода и упорядочиваются один раз: вставка каждой
+    //на своё место стоила бы O(k^2) перемещений для словаря из k ключей
+    const auto items_begin = dict_items_.begin() + begin;
+    const auto key_less = [](const Dict::value_type& lhs, const Dict::value_type& rhs) {
+        return lhs.first < rhs.first;
+    };
+    if (!std::is_sorted(items_begin, dict_items_.end(), key_less)) {
+        std::sort(items_begin, dict_items_.end(), key_less);
+    }
+    const auto duplicate = std::adjacent_find(items_begin, dict_items_.end(),
+        [](const Dict::value_type& lhs, const Dict::value_type& rhs) {
+            return lhs.first == rhs.first;
+        });
+    if (duplicate != dict_items_.end()) {
+        throw ParsingError("Duplicate key '"s + duplicate->first + "' have been found");
     }
+    Dict dict(std::vector<Dict::value_type>(std::make_move_iterator(items_begin),
+                                            std::make_move_iterator(dict_items_.end())));
+    dict_items_.erase(items_begin, dict_items_.end());
     return Node(std::move(dict));
 }
 
-Node LoadString(std::istream& input) {
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
+std::string Parser::LoadString() {
     std::string s;
     while (true) {
-        if (it == end) {
+        //Обычные символы переносим кусками до ближайшего особого
+        const char* chunk_end = FindStringSpecial(pos_, end_);
+        s.append(pos_, chunk_end);
+        pos_ = chunk_end;
+        if (pos_ == end_) {
             throw ParsingError("String parsing error");
         }
-        const char ch = *it;
+        const char ch = *pos_++;
         if (ch == '"') {
-            ++it;
             break;
         } else if (ch == '\\') {
-            ++it;
-            if (it == end) {
+            if (pos_ == end_) {
                 throw ParsingError("String parsing error");
             }
-            const char escaped_char = *(it);
+            const char escaped_char = *pos_++;
             switch (escaped_char) {
                 case 'n':
                     s.push_back('\n');
@@ -94,63 +361,51 @@ Node LoadString(std::istream& input) {
                 default:
                     throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
             }
-        } else if (ch == '\n' || ch == '\r') {
-            throw ParsingError("Unexpected end of line"s);
         } else {
-            s.push_back(ch);
+            throw ParsingError("Unexpected end of line"s);
         }
-        ++it;
     }
-
-    return Node(std::move(s));
+    return s;
 }
 
-Node LoadBool(std::istream& input) {
-    const auto s = LoadLiteral(input);
+Node Parser::LoadBool() {
+    const std::string_view s = LoadLiteral();
     if (s == "true"sv) {
         return Node{true};
     } else if (s == "false"sv) {
         return Node{false};
     } else {
-        throw ParsingError("Failed to parse '"s + s + "' as bool"s);
+        throw ParsingError("Failed to parse '"s + std::string(s) + "' as bool"s);
     }
 }
 
-Node LoadNull(std::istream& input) {
-    if (auto literal = LoadLiteral(input); literal == "null"sv) {
+Node Parser::LoadNull() {
+    if (const std::string_view literal = LoadLiteral(); literal == "null"sv) {
         return Node{nullptr};
     } else {
-        throw ParsingError("Failed to parse '"s + literal + "' as null"s);
+        throw ParsingError("Failed to parse '"s + std::string(literal) + "' as null"s);
     }
 }
 
-Node LoadNumber(std::istream& input) {
-    std::string parsed_num;
-
-    // Считывает в parsed_num очередной символ из input
-    auto read_char = [&parsed_num, &input] {
-        parsed_num += static_cast<char>(input.get());
-        if (!input) {
-            throw ParsingError("Failed to read number from stream"s);
-        }
-    };
+Node Parser::LoadNumber() {
+    const char* begin = pos_;
 
-    // Считывает одну или более цифр в parsed_num из input
-    auto read_digits = [&input, read_char] {
-        if (!std::isdigit(input.peek())) {
+    // Пропускает одну или более цифр
+    auto read_digits = [this] {
+        if (!IsDigit(Peek())) {
             throw ParsingError("A digit is expected"s);
         }
-        while (std::isdigit(input.peek())) {
-            read_char();
+        while (IsDigit(Peek())) {
+            ++pos_;
         }
     };
 
-    if (input.peek() == '-') {
-        read_char();
+    if (Peek() == '-') {
+        ++pos_;
     }
     // Парсим целую часть числа
-    if (input.peek() == '0') {
-        read_char();
+    if (Peek() == '0') {
+        ++pos_;
         // После 0 в JSON не могут идти другие цифры
     } else {
         read_digits();
@@ -158,50 +413,60 @@ Node LoadNumber(std::istream& input) {
 
     bool is_int = true;
     // Парсим дробную часть числа
-    if (input.peek() == '.') {
-        read_char();
+    if (Peek() == '.') {
+        ++pos_;
         read_digits();
         is_int = false;
     }
 
     // Парсим экспоненциальную часть числа
-    if (int ch = input.peek(); ch == 'e' || ch == 'E') {
-        read_char();
-        if (ch = input.peek(); ch == '+' || ch == '-') {
-            read_char();
+    if (int ch = Peek(); ch == 'e' || ch == 'E') {
+        ++pos_;
+        if (ch = Peek(); ch == '+' || ch == '-') {
+            ++pos_;
         }
         read_digits();
         is_int = false;
     }
 
-    try {
-        if (is_int) {
-            // Сначала пробуем преобразовать строку в int
-            try {
-                return std::stoi(parsed_num);
-            } catch (...) {
-                // В случае неудачи, например, при переполнении
-                // код ниже попробует преобразовать строку в double
-            }
+    if (is_int) {
+        // Сначала пробуем получить int. При переполнении
+        // код ниже преобразует строку в double
+        int value = 0;
+        if (const auto [end, ec] = std::from_chars(begin, pos_, value); ec == std::errc()) {
+            return value;
         }
+    }
+
+    //Для нормальных чисел from_chars и stod одинаково округляют до ближайшего.
+    //Ошибки и денормализованные числа (на них stod сообщает о выходе за диапазон)
+    //разбирает stod, чтобы сохранить прежнее поведение
+    double value = 0;
+    if (const auto [end, ec] = std::from_chars(begin, pos_, value);
+        ec == std::errc() && std::fpclassify(value) != FP_SUBNORMAL) {
+        return value;
+    }
+
+    const std::string parsed_num(begin, pos_);
+    try {
         return std::stod(parsed_num);
     } catch (...) {
         throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
     }
 }
 
-Node LoadNode(std::istream& input) {
+Node Parser::LoadNode() {
     char c;
-    if (!(input >> c)) {
+    if (!ReadChar(c)) {
         throw ParsingError("Unexpected EOF"s);
     }
     switch (c) {
         case '[':
-            return LoadArray(input);
+            return LoadArray();
         case '{':
-            return LoadDict(input);
+            return LoadDict();
         case '"':
-            return LoadString(input);
+            return LoadString();
         case 't':
             // Атрибут [[fallthrough]] (провалиться) ничего не делает, и является
             // подсказкой компилятору и человеку, что здесь программист явно задумывал
@@ -211,30 +476,66 @@ Node LoadNode(std::istream& input) {
             // литералов true либо false
             [[fallthrough]];
         case 'f':
-            input.putback(c);
-            return LoadBool(input);
+            --pos_;
+            return LoadBool();
         case 'n':
-            input.putback(c);
-            return LoadNull(input);
+            --pos_;
+            return LoadNull();
         default:
-            input.putback(c);
-            return LoadNumber(input);
+            --pos_;
+            return LoadNumber();
     }
 }
 
+Node Parser::LoadDocument() {
+    char c;
+    if (!ReadChar(c)) {
+        throw ParsingError("Unexpected EOF"s);
+    }
+    if (c == '{') {
+        return LoadDict(true);
+    }
+    --pos_;
+    return LoadNode();
+}
+
+// Весь остаток потока одним буфером
+std::string ReadAll(std::istream& input) {
+    constexpr size_t CHUNK_SIZE = 1 << 16;
+    std::string buffer;
+    while (input) {
+        const size_t size = buffer.size();
+        buffer.resize(size + CHUNK_SIZE);
+        input.read(buffer.data() + size, CHUNK_SIZE);
+        buffer.resize(size + static_cast<size_t>(input.gcount()));
+    }
+    return buffer;
+}
+
 struct PrintContext {
     std::ostream& out;
     int indent_step = 4;
     int indent = 0;
+    // Без переводов строк и отступов
+    bool compact = false;
 
     void PrintIndent() const {
+        if (compact) {
+            return;
+        }
         for (int i = 0; i < indent; ++i) {
             out.put(' ');
         }
     }
 
+    void PrintLineBreak() const {
+        if (!compact) {
+            out.put('\n');
+        }
+    }
+
     PrintContext Indented() const {
-        return {out, indent_step, indent_step + indent};
+        return {out, indent_step, indent_step + indent, compact};
     }
 };
 
@@ -245,31 +546,14 @@ void PrintValue(const Value& value, const PrintContext& ctx) {
     ctx.out << value;
 }
 
-void PrintString(const std::string& value, std::ostream& out) {
-    out.put('"');
-    for (const char c : value) {
-        switch (c) {
-            case '\r':
-                out << "\\r"sv;
-                break;
-            case '\n':
-                out << "\\n"sv;
-                break;
-            case '\t':
-                out << "\\t"sv;
-                break;
-            case '"':
-                // Символы " и \ выводятся как \" или \\, соответственно
-                [[fallthrough]];
-            case '\\':
-                out.put('\\');
-                [[fallthrough]];
-            default:
-                out.put(c);
-                break;
-        }
-    }
-    out.put('"');
+template <>
+void PrintValue<int>(const int& value, const PrintContext& ctx) {
+    PrintNumber(value, ctx.out);
+}
+
+template <>
+void PrintValue<double>(const double& value, const PrintContext& ctx) {
+    PrintNumber(value, ctx.out);
 }
 
 template <>
@@ -294,19 +578,21 @@ void PrintValue<bool>(const bool& value, const PrintContext& ctx) {
 template <>
 void PrintValue<Array>(const Array& nodes, const PrintContext& ctx) {
     std::ostream& out = ctx.out;
-    out << "[\n"sv;
+    out.put('[');
+    ctx.PrintLineBreak();
     bool first = true;
     auto inner_ctx = ctx.Indented();
     for (const Node& node : nodes) {
         if (first) {
             first = false;
         } else {
-            out << ",\n"sv;
+            out.put(',');
+            ctx.PrintLineBreak();
         }
         inner_ctx.PrintIndent();
         PrintNode(node, inner_ctx);
     }
-    out.put('\n');
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
     out.put(']');
 }
@@ -314,21 +600,23 @@ void PrintValue<Array>(const Array& nodes, const PrintContext& ctx) {
 template <>
 void PrintValue<Dict>(const Dict& nodes, const PrintContext& ctx) {
     std::ostream& out = ctx.out;
-    out << "{\n"sv;
+    out.put('{');
+    ctx.PrintLineBreak();
     bool first = true;
     auto inner_ctx = ctx.Indented();
     for (const auto& [key, node] : nodes) {
         if (first) {
             first = false;
         } else {
-            out << ",\n"sv;
+            out.put(',');
+            ctx.PrintLineBreak();
         }
         inner_ctx.PrintIndent();
         PrintString(key, ctx.out);
-        out << ": "sv;
+        out << (ctx.compact ? ":"sv : ": "sv);
         PrintNode(node, inner_ctx);
     }
-    out.put('\n');
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
     out.put('}');
 }
@@ -343,12 +631,120 @@ void PrintNode(const Node& node, const PrintContext& ctx) {
 
 }  // namespace
 
+memory::Usage Document::GetMemoryUsage() const {
+    return ComputeMemoryUsage(root_);
+}
+
+memory::Usage ComputeMemoryUsage(const Node& node) {
+    memory::Usage usage{0, 1};
+    if (node.IsArray()) {
+        usage.bytes += memory::GetHeapBytes(node.AsArray());
+        for (const Node& item : node.AsArray()) {
+            usage += ComputeMemoryUsage(item);
+        }
+    } else if (node.IsMap()) {
+        usage += ComputeMemoryUsage(node.AsMap());
+    } else if (node.IsString()) {
+        usage.bytes += memory::GetHeapBytes(node.AsString());
+    }
+    return usage;
+}
+
+memory::Usage ComputeMemoryUsage(const Dict& dict) {
+    memory::Usage usage{dict.capacity() * sizeof(Dict::value_type), 0};
+    for (const auto& [key, value] : dict) {
+        usage.bytes += memory::GetHeapBytes(key);
+        usage += ComputeMemoryUsage(value);
+    }
+    return usage;
+}
+
 Document Load(std::istream& input) {
-    return Document{LoadNode(input)};
+    return Load(ReadAll(input));
+}
+
+Document Load(std::string_view input) {
+    return Document{Parser(input).LoadNode()};
+}
+
+Document LoadStreaming(std::istream& input, const StreamHandlers& handlers) {
+    return LoadStreaming(ReadAll(input), handlers);
+}
+
+Document LoadStreaming(std::string_view input, const StreamHandlers& handlers) {
+    return Document{Parser(input, &handlers).LoadDocument()};
+}
+
+void PrintString(std::string_view value, std::ostream& out) {
+    out.put('"');
+    const char* pos = value.data();
+    const char* const end = pos + value.size();
+    while (true) {
+        //Символы, которые не нужно экранировать, выводим кусками до ближайшего особого
+        const char* chunk_end = FindEscaped(pos, end);
+        out.write(pos, chunk_end - pos);
+        if (chunk_end == end) {
+            break;
+        }
+        switch (const char c = *chunk_end) {
+            case '\r':
+                out << "\\r"sv;
+                break;
+            case '\n':
+                out << "\\n"sv;
+                break;
+            case '\t':
+                out << "\\t"sv;
+                break;
+            default:
+                // Символы " и \ выводятся как \" или \\, соответственно
+                out.put('\\');
+                out.put(c);
+                break;
+        }
+        pos = chunk_end + 1;
+    }
+    out.put('"');
+}
+
+namespace {
+
+//Поток выводит числа без особого форматирования: десятичные, без знака «+»,
+//ширины и принудительной точки, формат double по умолчанию, локаль "C"
+bool HasDefaultNumberFormat(const std::ostream& out) {
+    const std::ios::fmtflags format = out.flags() & (std::ios::basefield | std::ios::floatfield
+        | std::ios::showbase | std::ios::showpoint | std::ios::showpos | std::ios::uppercase);
+    return format == std::ios::dec && out.width() == 0 && out.getloc() == std::locale::classic();
+}
+
+}  // namespace
+
+void PrintNumber(int value, std::ostream& out) {
+    if (!HasDefaultNumberFormat(out)) {
+        out << value;
+        return;
+    }
+    char buffer[std::numeric_limits<int>::digits10 + 3];
+    const auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    out.write(buffer, end - buffer);
+}
+
+void PrintNumber(double value, std::ostream& out) {
+    //Формат по умолчанию у out << value — %g с точностью потока
+    char buffer[64];
+    if (HasDefaultNumberFormat(out)) {
+        const auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value,
+                                             std::chars_format::general, static_cast<int>(out.precision()));
+        if (ec == std::errc()) {
+            out.write(buffer, end - buffer);
+            return;
+        }
+    }
+    out << value;
 }
 
-void Print(const Document& doc, std::ostream& output) {
-    PrintNode(doc.GetRoot(), PrintContext{output});
+void Print(const Document& doc, std::ostream& output, PrintFormat format) {
+    PrintNode(doc.GetRoot(), PrintContext{output, 4, 0, format == PrintFormat::COMPACT});
 }
 
 }  // namespace json
\ No newline at end of file
@@ -1,15 +1,147 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <iostream>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "memory_usage.h"
+
 namespace json {
 
+/*
+ * Словарь в одном векторе пар, упорядоченных по ключу: поиск двоичный, вставка сдвигает хвост.
+ * Объекты JSON невелики, и так каждый занимает один блок памяти вместо узла дерева на ключ,
+ * быстрее обходится и освобождается. Интерфейс — используемая часть std::map; искать можно
+ * по любому ключу, сравнимому с Key (например, std::string_view).
+ */
+template <typename Key, typename Value>
+class FlatMap {
+public:
+    using value_type = std::pair<Key, Value>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    FlatMap() = default;
+    //items уже упорядочены по ключу и без повторов
+    explicit FlatMap(std::vector<value_type> items)
+        : items_(std::move(items)) {
+    }
+    FlatMap(std::initializer_list<value_type> items) {
+        for (const value_type& item : items) {
+            emplace(item.first, item.second);
+        }
+    }
+
+    iterator begin() {
+        return items_.begin();
+    }
+    iterator end() {
+        return items_.end();
+    }
+    const_iterator begin() const {
+        return items_.begin();
+    }
+    const_iterator end() const {
+        return items_.end();
+    }
+
+    size_t size() const {
+        return items_.size();
+    }
+    bool empty() const {
+        return items_.empty();
+    }
+    size_t capacity() const {
+        return items_.capacity();
+    }
+
+    template <typename K>
+    iterator lower_bound(const K& key) {
+        return std::lower_bound(items_.begin(), items_.end(), key, KeyLess{});
+    }
+    template <typename K>
+    const_iterator lower_bound(const K& key) const {
+        return std::lower_bound(items_.begin(), items_.end(), key, KeyLess{});
+    }
+
+    template <typename K>
+    iterator find(const K& key) {
+        const iterator it = lower_bound(key);
+        return it != end() && it->first == key ? it : end();
+    }
+    template <typename K>
+    const_iterator find(const K& key) const {
+        const const_iterator it = lower_bound(key);
+        return it != end() && it->first == key ? it : end();
+    }
+
+    template <typename K>
+    size_t count(const K& key) const {
+        return find(key) != end() ? 1 : 0;
+    }
+
+    template <typename K>
+    Value& at(const K& key) {
+        const iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("Key not found: " + std::string(key));
+        }
+        return it->second;
+    }
+    template <typename K>
+    const Value& at(const K& key) const {
+        const const_iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("Key not found: " + std::string(key));
+        }
+        return it->second;
+    }
+
+    Value& operator[](const Key& key) {
+        return emplace(key, Value{}).first->second;
+    }
+
+    //Как и у std::map, существующее значение не заменяется.
+    //Ключ больше всех имеющихся дописывается в конец за O(1), остальные сдвигают
+    //хвост вектора, поэтому много ключей вразнобой лучше собрать в вектор и отсортировать
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Key key, Args&&... args) {
+        if (items_.empty() || items_.back().first < key) {
+            items_.emplace_back(std::move(key), std::forward<Args>(args)...);
+            return {std::prev(items_.end()), true};
+        }
+        const iterator it = lower_bound(key);
+        if (it != end() && it->first == key) {
+            return {it, false};
+        }
+        return {items_.emplace(it, std::move(key), std::forward<Args>(args)...), true};
+    }
+    bool operator==(const FlatMap& rhs) const {
+        return items_ == rhs.items_;
+    }
+
+private:
+    struct KeyLess {
+        template <typename K>
+        bool operator()(const value_type& item, const K& key) const {
+            return item.first < key;
+        }
+    };
+
+    std::vector<value_type> items_;
+};
+
 class Node;
-using Dict = std::map<std::string, Node>;
+using Dict = FlatMap<std::string, Node>;
 using Array = std::vector<Node>;
 
 class ParsingError : public std::runtime_error {
@@ -131,6 +263,8 @@ public:
         return root_;
     }
 
+    memory::Usage GetMemoryUsage() const;
+
 private:
     Node root_;
 };
@@ -143,8 +277,36 @@ inline bool operator!=(const Document& lhs, const Document& rhs) {
     return !(lhs == rhs);
 }
 
+// Читает поток до конца и разбирает первое значение в нём
 Document Load(std::istream& input);
+// Разбирает первое значение в буфере; остаток буфера не проверяется
+Document Load(std::string_view input);
+
+// Обработчики потоковых массивов по ключам корневого словаря
+using StreamHandler = std::function<void(Node)>;
+using StreamHandlers = std::map<std::string, StreamHandler, std::less<>>;
+
+// Как Load, но массивы корневого словаря под ключами из handlers в документ не попадают:
+// каждый элемент передаётся обработчику сразу после разбора и больше не хранится,
+// а в документе на месте массива остаётся пустой. Так большой массив не занимает память целиком
+Document LoadStreaming(std::istream& input, const StreamHandlers& handlers);
+Document LoadStreaming(std::string_view input, const StreamHandlers& handlers);
+
+// Память значений узла и всех вложенных в него узлов; элементы — число узлов
+memory::Usage ComputeMemoryUsage(const Node& node);
+memory::Usage ComputeMemoryUsage(const Dict& dict);
+
+// Оформление вывода: с переводами строк и отступами по 4 пробела или без пробельных символов
+enum class PrintFormat {
+    PRETTY,
+    COMPACT,
+};
 
-void Print(const Document& doc, std::ostream& output);
+void Print(const Document& doc, std::ostream& output, PrintFormat format = PrintFormat::PRETTY);
+// Строка в кавычках, с экранированием, как её выводит Print
+void PrintString(std::string_view value, std::ostream& out);
+// Число, как его выводит Print: то же, что out << value, но без форматирования через локаль
+void PrintNumber(int value, std::ostream& out);
+void PrintNumber(double value, std::ostream& out);
 
 }  // namespace json
\ No newline at end of file
@@ -1,7 +1,16 @@
-#include <functional>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
 
 #include "json_reader.h"
-#include "json_builder.h"
+#include "json_writer.h"
+#include "serialization.h"
+#include "stat_requests.h"
 
 svg::Color ParseColor(const json::Node& node) {
     if (node.IsString()) {
@@ -36,201 +45,502 @@ namespace json {
 
 using namespace std::literals;
 
+void BaseRequestsData::Add(const Dict& request) {
+    const std::string& type = request.at("type"sv).AsString();
+    if (type == "Stop"sv) {
+        const std::string_view name = Intern(request.at("name"sv).AsString());
+        data_.stops.push_back({name, {request.at("latitude"sv).AsDouble(), request.at("longitude"sv).AsDouble()}, {}});
+        for (const auto& [to, distance] : request.at("road_distances"sv).AsMap()) {
+            data_.distances.push_back({name, Intern(to), distance.AsInt()});
+        }
+    } else if (type == "Bus"sv) {
+        std::vector<std::string_view> stops;
+        for (const Node& stop_name : request.at("stops"sv).AsArray()) {
+            stops.push_back(Intern(stop_name.AsString()));
+        }
+        const bool is_roundtrip = request.at("is_roundtrip"sv).AsBool();
+        if (!is_roundtrip && !stops.empty()) {
+            stops.reserve(stops.size() * 2 - 1);
+            for (size_t i = stops.size() - 1; i > 0; --i) {
+                stops.push_back(stops[i - 1]);
+            }
+        }
+        data_.buses.push_back({Intern(request.at("name"sv).AsString()), storage_.CopyRange(stops.begin(), stops.end()), 0, is_roundtrip});
+    }
+}
+
+const CatalogueData& BaseRequestsData::GetData() const {
+    return data_;
+}
+
+memory::Usage BaseRequestsData::GetMemoryUsage() const {
+    return {
+        storage_.GetMemoryUsage().bytes + memory::GetHeapBytes(names_) + memory::GetHeapBytes(data_.stops)
+            + memory::GetHeapBytes(data_.distances) + memory::GetHeapBytes(data_.buses),
+        data_.stops.size() + data_.buses.size()
+    };
+}
+
+std::string_view BaseRequestsData::Intern(std::string_view name) {
+    if (const auto it = names_.find(name); it != names_.end()) {
+        return *it;
+    }
+    return *names_.insert(storage_.CopyString(name)).first;
+}
+
 JsonReader::JsonReader(std::istream& in)
-: document_(Load(in).GetRoot().AsMap())
+: document_(LoadStreaming(in, MakeStreamHandlers()).GetRoot().AsMap())
 {}
 
+JsonReader::JsonReader(std::string_view input)
+: document_(LoadStreaming(input, MakeStreamHandlers()).GetRoot().AsMap())
+{}
 
-const TransportCatalogue& JsonReader::MakeDB() {
-    AddStops(document_["base_requests"s].AsArray());
-    AddDistances(document_["base_requests"s].AsArray());
-    AddBuses(document_["base_requests"s].AsArray());
-    return db_;
+StreamHandlers JsonReader::MakeStreamHandlers() {
+    return {{"base_requests"s, [this](Node request) {
+        base_requests_.Add(request.AsMap());
+    }}};
 }
 
-const TransportCatalogue& JsonReader::GetDB() const {
+const TransportCatalogue& JsonReader::MakeDB() {
+    db_.Load(base_requests_.GetData());
+    //Справочник скопировал имена в свою арену
+    base_requests_ = {};
     return db_;
 }
 
-void JsonReader::AddStops(const Array& base_requests){
-    for (auto item : base_requests){
-        auto item_as_map = item.AsMap();
-        if (item_as_map.at("type"s).AsString() == "Stop"s){
-            db_.AddStop({item_as_map.at("name"s).AsString(), {item_as_map.at("latitude"s).AsDouble(), item_as_map.at("longitude"s).AsDouble()}});
-        }
-    }
+bool JsonReader::HasRegions() const {
+    return document_.count("regions"sv) > 0;
 }
 
-void JsonReader::AddDistances(const Array& base_requests){
-    for (auto item : base_requests) {
-        auto item_as_map = item.AsMap();
-        if (item_as_map.at("type"s).AsString() == "Stop"s) {
-            std::vector<std::pair<std::string_view, int>> distances;
-            for (auto [name, distance] : item_as_map.at("road_distances"s).AsMap()) {
-                distances.push_back({ db_.FindStop(name)->name, distance.AsInt()});
+std::vector<routing::Shard> JsonReader::MakeRegionDBs() {
+    std::vector<routing::Shard> shards;
+    for (const Node& region : document_.at("regions"sv).AsArray()) {
+        const Dict& region_as_map = region.AsMap();
+        BaseRequestsData data;
+        for (const Node& request : region_as_map.at("base_requests"sv).AsArray()) {
+            data.Add(request.AsMap());
+        }
+        TransportCatalogue& db = region_dbs_.emplace_back();
+        db.Load(data.GetData());
+        std::vector<std::string_view> boundary_stops;
+        if (region_as_map.count("boundary_stops"sv)) {
+            for (const Node& stop_name : region_as_map.at("boundary_stops"sv).AsArray()) {
+                boundary_stops.emplace_back(stop_name.AsString());
             }
-            db_.AddDistance( item_as_map.at("name"s).AsString(), distances );
         }
+        shards.push_back({region_as_map.at("name"sv).AsString(), db, std::move(boundary_stops)});
     }
+    return shards;
 }
 
-void JsonReader::AddBuses(const Array& base_requests){
-    for (auto item : base_requests) {
-        auto item_as_map = item.AsMap();
-        if (item_as_map.at("type"s).AsString() == "Bus"s) {
-            std::vector<std::string_view> stops;
-            for (auto stop_name : item_as_map.at("stops"s).AsArray()) {
-                stops.emplace_back(db_.FindStop(stop_name.AsString())->name);
-            }
-            if (!item_as_map.at("is_roundtrip"s).AsBool()) {
-                std::vector<std::string_view> results(stops.begin(), stops.end());
-                results.insert(results.end(), std::next(stops.rbegin()), stops.rend());
-                stops = std::move(results);
-            }
-            db_.AddBus({ item_as_map.at("name"s).AsString(), stops , 0,  item_as_map.at("is_roundtrip"s).AsBool() });
-        }
+const TransportCatalogue& JsonReader::LoadDB(const std::string& path, bool out_of_core) {
+    if (out_of_core) {
+        serialization::MapCatalogue(path, db_);
+    } else {
+        serialization::LoadCatalogue(path, db_);
     }
+    base_requests_ = {};
+    return db_;
+}
+
+memory::Usage JsonReader::GetDocumentMemoryUsage() const {
+    memory::Usage usage = ComputeMemoryUsage(document_);
+    usage += base_requests_.GetMemoryUsage();
+    return usage;
+}
+
+const TransportCatalogue& JsonReader::GetDB() const {
+    return db_;
+}
+
+TransportCatalogue JsonReader::ReleaseDB() {
+    return std::move(db_);
 }
 
 renderer::RenderSettings JsonReader::ParseRenderSettings() const {
     renderer::RenderSettings settings;
-    const Dict render_settings = document_.at("render_settings"s).AsMap();
-    settings.width = render_settings.at("width"s).AsDouble();
-    settings.height = render_settings.at("height"s).AsDouble();
-    settings.padding = render_settings.at("padding"s).AsDouble();
-    settings.line_width = render_settings.at("line_width"s).AsDouble();
-    settings.stop_radius = render_settings.at("stop_radius"s).AsDouble();
-    settings.bus_label_font_size = render_settings.at("bus_label_font_size"s).AsInt();
+    const Dict& render_settings = document_.at("render_settings"sv).AsMap();
+    settings.width = render_settings.at("width"sv).AsDouble();
+    settings.height = render_settings.at("height"sv).AsDouble();
+    settings.padding = render_settings.at("padding"sv).AsDouble();
+    settings.line_width = render_settings.at("line_width"sv).AsDouble();
+    settings.stop_radius = render_settings.at("stop_radius"sv).AsDouble();
+    settings.bus_label_font_size = render_settings.at("bus_label_font_size"sv).AsInt();
     settings.bus_label_offset =  {
-        render_settings.at("bus_label_offset"s).AsArray()[0].AsDouble(),
-        render_settings.at("bus_label_offset"s).AsArray()[1].AsDouble()
+        render_settings.at("bus_label_offset"sv).AsArray()[0].AsDouble(),
+        render_settings.at("bus_label_offset"sv).AsArray()[1].AsDouble()
     };
-    settings.stop_label_font_size = render_settings.at("stop_label_font_size"s).AsInt();
+    settings.stop_label_font_size = render_settings.at("stop_label_font_size"sv).AsInt();
     settings.stop_label_offset = {
-        render_settings.at("stop_label_offset"s).AsArray()[0].AsDouble(),
-        render_settings.at("stop_label_offset"s).AsArray()[1].AsDouble()
+        render_settings.at("stop_label_offset"sv).AsArray()[0].AsDouble(),
+        render_settings.at("stop_label_offset"sv).AsArray()[1].AsDouble()
     };
-    settings.underlayer_color = ParseColor(render_settings.at("underlayer_color"));
-    settings.underlayer_width = render_settings.at("underlayer_width"s).AsDouble();
-    settings.color_palette = ParseColor(render_settings.at("color_palette"s).AsArray());
+    settings.underlayer_color = ParseColor(render_settings.at("underlayer_color"sv));
+    settings.underlayer_width = render_settings.at("underlayer_width"sv).AsDouble();
+    settings.color_palette = ParseColor(render_settings.at("color_palette"sv).AsArray());
     return settings;
 }
 
+namespace {
+
+//Скорости делят расстояние, а время ожидания становится весом ребра: нулевая скорость
+//дала бы бесконечные веса, а отрицательные значения — отрицательные, с которыми
+//поиск кратчайших маршрутов не работает
+double CheckPositive(double value, std::string_view name) {
+    if (!(value > 0)) {
+        throw std::invalid_argument("Routing setting "s + std::string(name) + " must be positive"s);
+    }
+    return value;
+}
+
+double CheckNonNegative(double value, std::string_view name) {
+    if (!(value >= 0)) {
+        throw std::invalid_argument("Routing setting "s + std::string(name) + " must not be negative"s);
+    }
+    return value;
+}
+
+} // namespace
+
 routing::RoutingSettings JsonReader::ParseRoutingSettings() const {
     routing::RoutingSettings settings;
-    const Dict routing_settings = document_.at("routing_settings"s).AsMap();
-    settings.bus_wait_time = routing_settings.at("bus_wait_time").AsInt();
-    settings.bus_velocity = routing_settings.at("bus_velocity"s).AsInt();
+    const Dict& routing_settings = document_.at("routing_settings"sv).AsMap();
+    settings.bus_wait_time = routing_settings.at("bus_wait_time"sv).AsInt();
+    CheckNonNegative(settings.bus_wait_time, "bus_wait_time"sv);
+    settings.bus_velocity = routing_settings.at("bus_velocity"sv).AsInt();
+    CheckPositive(settings.bus_velocity, "bus_velocity"sv);
+    //Без walk_transfer_distance пешие пересадки отключены
+    if (routing_settings.count("walk_transfer_distance"sv)) {
+        settings.walk_transfer_distance = CheckPositive(routing_settings.at("walk_transfer_distance"sv).AsDouble(),
+                                                        "walk_transfer_distance"sv);
+    }
+    if (routing_settings.count("walk_velocity"sv)) {
+        settings.walk_velocity = CheckPositive(routing_settings.at("walk_velocity"sv).AsDouble(), "walk_velocity"sv);
+    }
+    if (routing_settings.count("bus_velocities"sv)) {
+        for (const auto& [bus_name, velocity] : routing_settings.at("bus_velocities"sv).AsMap()) {
+            settings.bus_velocities.emplace(bus_name, CheckPositive(velocity.AsDouble(), "bus_velocities"sv));
+        }
+    }
+    if (routing_settings.count("stop_wait_times"sv)) {
+        for (const auto& [stop_name, wait_time] : routing_settings.at("stop_wait_times"sv).AsMap()) {
+            settings.stop_wait_times.emplace(stop_name, CheckNonNegative(wait_time.AsDouble(), "stop_wait_times"sv));
+        }
+    }
     return settings;
 }
 
 
+//Разбирает запрос stat_requests; неизвестный тип — invalid_argument
+requests::StatRequest ParseStatRequest(const Dict& request) {
+    const int id = request.at("id"sv).AsInt();
+    const std::string& type = request.at("type"sv).AsString();
+    if (type == "Bus"sv) {
+        return requests::BusRequest{id, request.at("name"sv).AsString()};
+    } else if (type == "Stop"sv) {
+        return requests::StopRequest{id, request.at("name"sv).AsString()};
+    } else if (type == "DirectBuses"sv) {
+        return requests::DirectBusesRequest{id, request.at("from"sv).AsString(), request.at("to"sv).AsString()};
+    } else if (type == "Route"sv) {
+        return requests::RouteRequest{id, request.at("from"sv).AsString(), request.at("to"sv).AsString()};
+    } else if (type == "Map"sv) {
+        return requests::MapRequest{id};
+    } else if (type == "NearestStops"sv) {
+        return requests::NearestStopsRequest{
+            id,
+            {request.at("latitude"sv).AsDouble(), request.at("longitude"sv).AsDouble()},
+            request.count("count"sv) ? request.at("count"sv).AsInt() : 1
+        };
+    } else if (type == "StopsInArea"sv) {
+        return requests::StopsInAreaRequest{id, {
+            {request.at("min_latitude"sv).AsDouble(), request.at("min_longitude"sv).AsDouble()},
+            {request.at("max_latitude"sv).AsDouble(), request.at("max_longitude"sv).AsDouble()}
+        }};
+    } else if (type == "StopSearch"sv) {
+        const std::string& query = request.at("query"sv).AsString();
+        return requests::StopSearchRequest{
+            id,
+            query,
+            request.count("count"sv) ? request.at("count"sv).AsInt() : 10,
+            request.count("max_errors"sv)
+                ? request.at("max_errors"sv).AsInt()
+                : search::StopSearch::GetDefaultMaxErrors(query)
+        };
+    } else if (type == "Stats"sv) {
+        return requests::StatsRequest{id};
+    }
+    throw std::invalid_argument("Unknown request type: "s + type);
+}
+
+std::vector<requests::StatRequest> ParseStatRequests(const Array& stat_requests) {
+    std::vector<requests::StatRequest> result;
+    result.reserve(stat_requests.size());
+    for (const Node& request : stat_requests) {
+        result.push_back(ParseStatRequest(request.AsMap()));
+    }
+    return result;
+}
+
 //Структура которая хранит ссылки на всё необходимое для отрисовки выходного JSON файла
 struct PrintJsonSource {
-    json::Builder& result;
+    json::Writer& result;
     const TransportCatalogue& db;
-    const json::Node& request;
-    const std::string& map;
+    std::string_view map;
     const routing::TransportRouter& transport_router;
+    const memory::Reports& memory_reports;
 };
 
-void StatRequestBus(PrintJsonSource source) {
-    auto [stops_count, unique_stops_count, route_length, curvature] = source.db.GetBusInfo(source.request.AsMap().at("name"s).AsString());
+//Ответы выводятся сразу в поток, поэтому ключи каждого словаря перечисляются по алфавиту
+
+void PrintNotFound(json::Writer& result, int request_id) {
+    result.StartDict().
+        Key("error_message"sv).Value("not found"sv).
+        Key("request_id"sv).Value(request_id).
+        EndDict();
+}
+
+void PrintBusInfo(json::Writer& result, int request_id, const BusInfo& info) {
+    auto [stops_count, unique_stops_count, route_length, curvature] = info;
     if (!stops_count) {
-        source.result.StartDict().
-            Key("request_id"s).Value(source.request.AsMap().at("id"s).AsInt()).
-            Key("error_message"s).Value("not found"s).
-            EndDict();
+        PrintNotFound(result, request_id);
     }
     else {
-        source.result.StartDict().
-            Key("curvature"s).Value(curvature).
-            Key("request_id"s).Value(source.request.AsMap().at("id"s).AsInt()).
-            Key("route_length"s).Value(route_length).
-            Key("stop_count"s).Value(static_cast<int>(stops_count)).
-            Key("unique_stop_count"s).Value(static_cast<int>(unique_stops_count)).
+        result.StartDict().
+            Key("curvature"sv).Value(curvature).
+            Key("request_id"sv).Value(request_id).
+            Key("route_length"sv).Value(route_length).
+            Key("stop_count"sv).Value(static_cast<int>(stops_count)).
+            Key("unique_stop_count"sv).Value(static_cast<int>(unique_stops_count)).
             EndDict();
     }
 }
 
-void StatRequestStop(PrintJsonSource source) {
-    auto stop = source.db.FindStop(source.request.AsMap().at("name"s).AsString());
-    if (stop == nullptr) {
-        source.result.StartDict().
-            Key("request_id"s).Value(source.request.AsMap().at("id"s).AsInt()).
-            Key("error_message"s).Value("not found"s).
-            EndDict();
+void PrintStatResponse(PrintJsonSource source, const requests::BusRequest& request) {
+    PrintBusInfo(source.result, request.id, source.db.GetBusInfo(request.name));
+}
+
+//buses_on_stop — nullopt, если остановки нет
+void PrintBusesOnStop(json::Writer& result, int request_id, const std::optional<std::vector<std::string_view>>& buses_on_stop) {
+    if (!buses_on_stop) {
+        PrintNotFound(result, request_id);
         return;
     }
-    auto buses_on_stop = source.db.GetBusesOnStop(source.request.AsMap().at("name"s).AsString());
-    json::Array buses;
-    for (auto bus : buses_on_stop) {
-        buses.emplace_back(std::string(bus));
+    result.StartDict().Key("buses"sv).StartArray();
+    for (std::string_view bus : *buses_on_stop) {
+        result.Value(bus);
     }
-    source.result.StartDict().
-        Key("request_id"s).Value(source.request.AsMap().at("id"s).AsInt()).
-        Key("buses"s).Value(buses).
+    result.EndArray().
+        Key("request_id"sv).Value(request_id).
         EndDict();
 }
 
-void StatRequestRoute(PrintJsonSource source){
-    std::string_view from = source.request.AsMap().at("from"s).AsString();
-    std::string_view to = source.request.AsMap().at("to"s).AsString();
-    std::pair<double, std::vector<std::variant<routing::StopEdge, routing::BusEdge>>> info =
-        source.transport_router.BuildRoute(from, to);
+void PrintStatResponse(PrintJsonSource source, const requests::StopRequest& request) {
+    PrintBusesOnStop(source.result, request.id, source.db.GetBusesOnStop(request.name));
+}
+
+void PrintStatResponse(PrintJsonSource source, const requests::DirectBusesRequest& request) {
+    PrintBusesOnStop(source.result, request.id, source.db.GetDirectBuses(request.from, request.to));
+}
+
+void PrintRoute(json::Writer& result, int request_id, const std::pair<double, std::vector<routing::RouteItem>>& info) {
     if (info.first == -1) { // если маршрута между указанными остановками нет
-        source.result.StartDict().
-            Key("request_id"s).Value(source.request.AsMap().at("id"s).AsInt()).
-            Key("error_message"s).Value("not found"s).
-            EndDict();
+        PrintNotFound(result, request_id);
         return;
     }
-    source.result.StartDict().
-        Key("request_id"s).Value(source.request.AsMap().at("id"s).AsInt()).
-        Key("total_time"s).Value(info.first).
-        Key("items"s).StartArray();
-
+    result.StartDict().Key("items"sv).StartArray();
     for (const auto& item : info.second){
-        source.result.StartDict();
-        if (std::holds_alternative<routing::StopEdge>(item)){
-            source.result.
-            Key("type"s).Value("Wait"s).
-            Key("stop_name"s).Value(std::string(std::get<routing::StopEdge>(item).stop_name)).
-            Key("time"s).Value(std::get<routing::StopEdge>(item).time);
+        result.StartDict();
+        if (const auto* wait = std::get_if<routing::StopEdge>(&item)){
+            result.
+            Key("stop_name"sv).Value(wait->stop_name).
+            Key("time"sv).Value(wait->time).
+            Key("type"sv).Value("Wait"sv);
+        } else if (const auto* bus = std::get_if<routing::BusEdge>(&item)) {
+            result.
+            Key("bus"sv).Value(bus->bus).
+            Key("span_count"sv).Value(bus->span_count).
+            Key("time"sv).Value(bus->time).
+            Key("type"sv).Value("Bus"sv);
         } else {
-            source.result.
-            Key("type"s).Value("Bus"s).
-            Key("bus"s).Value(std::string(std::get<routing::BusEdge>(item).bus)).
-            Key("span_count"s).Value(std::get<routing::BusEdge>(item).span_count).
-            Key("time"s).Value(std::get<routing::BusEdge>(item).time);
+            const auto& walk = std::get<routing::WalkEdge>(item);
+            result.
+            Key("from"sv).Value(walk.from).
+            Key("time"sv).Value(walk.time).
+            Key("to"sv).Value(walk.to).
+            Key("type"sv).Value("Walk"sv);
         }
-        source.result.EndDict();
+        result.EndDict();
+    }
+    result.EndArray().
+        Key("request_id"sv).Value(request_id).
+        Key("total_time"sv).Value(info.first).
+        EndDict();
+}
+
+void PrintStatResponse(PrintJsonSource source, const requests::RouteRequest& request){
+    PrintRoute(source.result, request.id, source.transport_router.BuildRoute(request.from, request.to));
+}
+
+void PrintStatResponse(PrintJsonSource source, const requests::MapRequest& request){
+    source.result.StartDict().
+    Key("map"sv).Value(source.map).
+    Key("request_id"sv).Value(request.id).
+    EndDict();
+}
+
+void PrintStatResponse(PrintJsonSource source, const requests::NearestStopsRequest& request) {
+    source.result.StartDict().
+        Key("request_id"sv).Value(request.id).
+        Key("stops"sv).StartArray();
+    for (const auto& [stop, distance] : source.db.GetStopIndex().FindNearest(request.point, std::max(request.count, 0))) {
+        source.result.StartDict().
+            Key("distance"sv).Value(distance).
+            Key("name"sv).Value(stop->name).
+            EndDict();
     }
     source.result.EndArray();
     source.result.EndDict();
 }
 
-void StatRequestMap(PrintJsonSource source){
+void PrintStatResponse(PrintJsonSource source, const requests::StopsInAreaRequest& request) {
     source.result.StartDict().
-    Key("request_id"s).Value(source.request.AsMap().at("id"s).AsInt()).
-    Key("map"s).Value(source.map).
-    EndDict();
+        Key("request_id"sv).Value(request.id).
+        Key("stops"sv).StartArray();
+    for (const Stop* stop : source.db.GetStopIndex().FindInArea(request.area)) {
+        source.result.Value(stop->name);
+    }
+    source.result.EndArray();
+    source.result.EndDict();
 }
 
-void JsonReader::PrintJson(std::ostream& out, const routing::TransportRouter& transport_router, const std::string map) const{
-    json::Builder result;
+void PrintStatResponse(PrintJsonSource source, const requests::StopSearchRequest& request) {
+    source.result.StartDict().
+        Key("request_id"sv).Value(request.id).
+        Key("stops"sv).StartArray();
+    for (const auto& [stop, errors] : source.db.GetStopSearch().Find(request.query, std::max(request.count, 0), request.max_errors)) {
+        source.result.StartDict().
+            Key("errors"sv).Value(errors).
+            Key("name"sv).Value(stop->name).
+            EndDict();
+    }
+    source.result.EndArray();
+    source.result.EndDict();
+}
+
+//Счётчики памяти могут не поместиться в int
+Writer::Scalar MakeCounter(size_t value) {
+    if (value <= static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return static_cast<int>(value);
+    }
+    return static_cast<double>(value);
+}
+
+void PrintStatResponse(PrintJsonSource source, const requests::StatsRequest& request) {
+    //Компоненты и части — по алфавиту; из одноимённых выводится последняя
+    size_t total_bytes = 0;
+    std::map<std::string_view, const memory::Report*> components;
+    for (const auto& [name, report] : source.memory_reports) {
+        components[name] = &report;
+        total_bytes += report.GetTotalBytes();
+    }
+    source.result.StartDict().Key("components"sv).StartDict();
+    for (const auto& [name, report] : components) {
+        std::map<std::string_view, memory::Usage> parts;
+        for (const auto& [part_name, usage] : report->parts) {
+            parts[part_name] = usage;
+        }
+        source.result.Key(name).StartDict().
+            Key("bytes"sv).Value(MakeCounter(report->GetTotalBytes())).
+            Key("parts"sv).StartDict();
+        for (const auto& [part_name, usage] : parts) {
+            source.result.Key(part_name).StartDict().
+                Key("bytes"sv).Value(MakeCounter(usage.bytes)).
+                Key("items"sv).Value(MakeCounter(usage.items)).
+                EndDict();
+        }
+        source.result.EndDict().EndDict();
+    }
+    source.result.EndDict().
+        Key("request_id"sv).Value(request.id).
+        Key("total_bytes"sv).Value(MakeCounter(total_bytes)).
+        EndDict();
+}
+
+void PrintStatResponse(PrintJsonSource source, const requests::StatRequest& request) {
+    std::visit([source](const auto& typed_request) {
+        PrintStatResponse(source, typed_request);
+    }, request);
+}
+
+void JsonReader::PrintJson(std::ostream& out, const routing::TransportRouter& transport_router, std::string_view map,
+                           const memory::Reports& memory_reports, PrintFormat format) const{
+    const std::vector<requests::StatRequest> stat_requests = ParseStatRequests(document_.at("stat_requests"sv).AsArray());
+    json::Writer result(out, format);
     result.StartArray();
-    std::unordered_map<std::string, std::function<void(PrintJsonSource)>> request_types;
-    request_types["Bus"s] = StatRequestBus;
-    request_types["Stop"s] = StatRequestStop;
-    request_types["Route"s] = StatRequestRoute;
-    request_types["Map"s] = StatRequestMap;
-    for (const auto& request : document_.at("stat_requests"s).AsArray()) {
-        request_types[request.AsMap().at("type"s).AsString()]({result, db_, request, map, transport_router});
+    for (const requests::StatRequest& request : stat_requests) {
+        PrintStatResponse({result, db_, map, transport_router, memory_reports}, request);
+    }
+    result.EndArray();
+}
+
+void JsonReader::PrintResponse(std::ostream& out, const Node& request, const TransportCatalogue& db,
+                               const routing::TransportRouter& transport_router, std::string_view map,
+                               const memory::Reports& memory_reports, PrintFormat format) const {
+    const requests::StatRequest stat_request = ParseStatRequest(request.AsMap());
+    json::Writer result(out, format);
+    PrintStatResponse({result, db, map, transport_router, memory_reports}, stat_request);
+}
+
+const Array& JsonReader::GetStatRequests() const {
+    static const Array no_requests;
+    const auto it = document_.find("stat_requests"sv);
+    return it != document_.end() ? it->second.AsArray() : no_requests;
+}
+
+void JsonReader::PrintShardedJson(std::ostream& out, const routing::ShardedRouter& router, PrintFormat format) const {
+    const std::vector<requests::StatRequest> stat_requests = ParseStatRequests(document_.at("stat_requests"sv).AsArray());
+    json::Writer result(out, format);
+    result.StartArray();
+    for (const requests::StatRequest& stat_request : stat_requests) {
+        std::visit([&](const auto& request) {
+            using Request = std::decay_t<decltype(request)>;
+            if constexpr (std::is_same_v<Request, requests::RouteRequest>) {
+                PrintRoute(result, request.id, router.BuildRoute(request.from, request.to));
+            } else if constexpr (std::is_same_v<Request, requests::BusRequest>) {
+                //Маршрут целиком лежит в одном регионе
+                BusInfo info;
+                for (const TransportCatalogue& db : region_dbs_) {
+                    if (info = db.GetBusInfo(request.name); info.stops_on_route) {
+                        break;
+                    }
+                }
+                PrintBusInfo(result, request.id, info);
+            } else if constexpr (std::is_same_v<Request, requests::StopRequest>) {
+                //Через пограничную остановку идут автобусы всех её регионов
+                std::optional<std::vector<std::string_view>> buses_on_stop;
+                for (const TransportCatalogue& db : region_dbs_) {
+                    if (const auto region_buses = db.GetBusesOnStop(request.name)) {
+                        if (!buses_on_stop) {
+                            buses_on_stop.emplace();
+                        }
+                        buses_on_stop->insert(buses_on_stop->end(), region_buses->begin(), region_buses->end());
+                    }
+                }
+                if (buses_on_stop) {
+                    std::sort(buses_on_stop->begin(), buses_on_stop->end());
+                    buses_on_stop->erase(std::unique(buses_on_stop->begin(), buses_on_stop->end()), buses_on_stop->end());
+                }
+                PrintBusesOnStop(result, request.id, buses_on_stop);
+            } else {
+                result.StartDict().
+                    Key("error_message"sv).Value("not supported for regions"sv).
+                    Key("request_id"sv).Value(request.id).
+                    EndDict();
+            }
+        }, stat_request);
     }
     result.EndArray();
-    json::Document doc(result.Build());
-    json::Print(doc, out);
 }
 
 }
\ No newline at end of file
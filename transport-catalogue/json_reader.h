@@ -1,29 +1,82 @@
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
 
+#include "arena.h"
 #include "json.h"
 #include "map_renderer.h"
+#include "memory_usage.h"
+#include "sharded_router.h"
 #include "transport_catalogue.h"
 #include "transport_router.h"
 
 namespace json {
 
+//Базовые запросы, собранные в данные для TransportCatalogue::Load. Имена и списки остановок
+//копируются в собственную арену (одинаковые имена — один раз), поэтому разобранные узлы
+//JSON можно освобождать сразу после Add
+class BaseRequestsData {
+public:
+    void Add(const Dict& request);
+    //Ссылается на арену объекта: действительно, пока он жив и не изменялся
+    const CatalogueData& GetData() const;
+    memory::Usage GetMemoryUsage() const;
+
+private:
+    memory::Arena storage_;
+    std::unordered_set<std::string_view> names_;
+    CatalogueData data_;
+
+    std::string_view Intern(std::string_view name);
+};
+
 class JsonReader {
 public:
+    //base_requests корневого словаря не хранятся в документе: каждый запрос
+    //переводится в BaseRequestsData сразу после разбора
     explicit JsonReader(std::istream& in);
+    explicit JsonReader(std::string_view input);
     renderer::RenderSettings ParseRenderSettings() const;
     routing::RoutingSettings ParseRoutingSettings() const;
     const TransportCatalogue& MakeDB();
+    //Загружает справочник из двоичного файла вместо base_requests.
+    //out_of_core — дорожные расстояния не загружать, а читать из файла по запросу
+    const TransportCatalogue& LoadDB(const std::string& path, bool out_of_core = false);
     const TransportCatalogue& GetDB() const;
-    void PrintJson(std::ostream& out, const routing::TransportRouter& transport_router, std::string map) const;
+    //Забирает построенный справочник; GetDB после этого не вызывается
+    TransportCatalogue ReleaseDB();
+    //Память разобранного входного документа и ещё не загруженных в справочник base_requests
+    memory::Usage GetDocumentMemoryUsage() const;
+    //memory_reports — ответ на запросы Stats
+    void PrintJson(std::ostream& out, const routing::TransportRouter& transport_router, std::string_view map,
+                   const memory::Reports& memory_reports, PrintFormat format = PrintFormat::PRETTY) const;
+    //Ответ на один запрос из stat_requests — отдельный документ JSON. Справочник передаётся
+    //явно: запросы потока могут отвечать по версии справочника, построенной после чтения документа
+    void PrintResponse(std::ostream& out, const Node& request, const TransportCatalogue& db,
+                       const routing::TransportRouter& transport_router, std::string_view map,
+                       const memory::Reports& memory_reports, PrintFormat format) const;
+    //Запросы stat_requests документа; пусто, если их нет
+    const Array& GetStatRequests() const;
+
+    //Документ описывает несколько регионов ("regions") вместо общих base_requests
+    bool HasRegions() const;
+    //Строит отдельный справочник для каждого региона
+    std::vector<routing::Shard> MakeRegionDBs();
+    //Отвечает на запросы Bus, Stop и Route по всем регионам
+    void PrintShardedJson(std::ostream& out, const routing::ShardedRouter& router, PrintFormat format = PrintFormat::PRETTY) const;
 
 private:
-    void AddStops(const Array& base_requests);
-    void AddDistances(const Array& base_requests);
-    void AddBuses(const Array& base_requests);
+    //Обработчик потокового массива base_requests
+    StreamHandlers MakeStreamHandlers();
 
     TransportCatalogue db_;
+    std::deque<TransportCatalogue> region_dbs_;
+    //Запросы из base_requests до построения справочника
+    BaseRequestsData base_requests_;
     Dict document_;
 };
 
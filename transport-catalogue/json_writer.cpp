@@ -0,0 +1,191 @@
+#include "json_writer.h"
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "json.h"
+
+namespace json {
+
+using namespace std::literals;
+
+//----------------WRITER-----------------
+
+Writer::Writer(std::ostream& out, PrintFormat format)
+: out_(out)
+, compact_(format == PrintFormat::COMPACT)
+{}
+
+Writer::KeyItemContext Writer::Key(std::string_view key){
+    if (scopes_.empty() || !scopes_.back().is_dict || scopes_.back().awaits_value){
+        throw std::logic_error("Expected NOT a key here!"s);
+    }
+    Scope& scope = scopes_.back();
+    if (scope.has_items){
+        //Print выводит ключи словаря по алфавиту
+        if (key <= scope.last_key){
+            throw std::logic_error("Keys must be unique and sorted: "s + std::string(key));
+        }
+        PrintSeparator();
+    }
+    scope.has_items = true;
+    scope.awaits_value = true;
+    scope.last_key.assign(key);
+    PrintIndent(scopes_.size());
+    PrintString(key, out_);
+    out_ << (compact_ ? ":"sv : ": "sv);
+    return {*this};
+}
+
+Writer& Writer::Value(Scalar value){
+    BeginValue();
+    std::visit([this](const auto& scalar) {
+        using Type = std::decay_t<decltype(scalar)>;
+        if constexpr (std::is_same_v<Type, std::nullptr_t>) {
+            out_ << "null"sv;
+        } else if constexpr (std::is_same_v<Type, bool>) {
+            out_ << (scalar ? "true"sv : "false"sv);
+        } else if constexpr (std::is_same_v<Type, std::string_view>) {
+            PrintString(scalar, out_);
+        } else {
+            PrintNumber(scalar, out_);
+        }
+    }, value);
+    return *this;
+}
+
+Writer::DictItemContext Writer::StartDict(){
+    BeginValue();
+    out_.put('{');
+    PrintLineBreak();
+    scopes_.emplace_back().is_dict = true;
+    return {*this};
+}
+
+Writer::ArrayItemContext Writer::StartArray(){
+    BeginValue();
+    out_.put('[');
+    PrintLineBreak();
+    scopes_.emplace_back();
+    return {*this};
+}
+
+Writer& Writer::EndDict(){
+    if (scopes_.empty() || !scopes_.back().is_dict || scopes_.back().awaits_value){
+        throw std::logic_error("Not a Dict!");
+    }
+    scopes_.pop_back();
+    PrintLineBreak();
+    PrintIndent(scopes_.size());
+    out_.put('}');
+    return *this;
+}
+
+Writer& Writer::EndArray(){
+    if (scopes_.empty() || scopes_.back().is_dict){
+        throw std::logic_error("Not an Array!");
+    }
+    scopes_.pop_back();
+    PrintLineBreak();
+    PrintIndent(scopes_.size());
+    out_.put(']');
+    return *this;
+}
+
+void Writer::BeginValue(){
+    if (scopes_.empty()){
+        if (has_root_){
+            throw std::logic_error("Expected NOT a value here!");
+        }
+        has_root_ = true;
+        return;
+    }
+    Scope& scope = scopes_.back();
+    if (scope.is_dict){
+        if (!scope.awaits_value){
+            throw std::logic_error("Expected NOT a value here!");
+        }
+        scope.awaits_value = false;
+        return;
+    }
+    if (scope.has_items){
+        PrintSeparator();
+    }
+    scope.has_items = true;
+    PrintIndent(scopes_.size());
+}
+
+void Writer::PrintSeparator(){
+    out_.put(',');
+    PrintLineBreak();
+}
+
+void Writer::PrintLineBreak(){
+    if (!compact_){
+        out_.put('\n');
+    }
+}
+
+void Writer::PrintIndent(size_t depth){
+    if (compact_){
+        return;
+    }
+    //Отступ, как у Print, — 4 пробела на уровень
+    for (size_t i = 0; i < depth * 4; ++i) {
+        out_.put(' ');
+    }
+}
+
+//---------------WRITER_ITEM_CONTEXT---------------
+
+Writer::WriterItemContext::WriterItemContext(Writer& writer)
+: writer_(writer)
+{}
+
+Writer& Writer::WriterItemContext::GetWriter(){
+    return writer_;
+}
+
+//----------------DICT_ITEM_CONTEXT-----------------
+
+Writer::KeyItemContext Writer::DictItemContext::Key(std::string_view key) {
+    return GetWriter().Key(key);
+}
+
+Writer& Writer::DictItemContext::EndDict() {
+    return GetWriter().EndDict();
+}
+
+//-----------------KEY_ITEM_CONTEXT-----------------
+
+Writer::DictItemContext Writer::KeyItemContext::Value(Scalar value){
+    return {GetWriter().Value(value)};
+}
+
+Writer::DictItemContext Writer::KeyItemContext::StartDict(){
+    return GetWriter().StartDict();
+}
+
+Writer::ArrayItemContext Writer::KeyItemContext::StartArray(){
+    return GetWriter().StartArray();
+}
+
+//-----------------ARRAY_ITEM_CONTEXT-----------------
+
+Writer::ArrayItemContext Writer::ArrayItemContext::Value(Scalar value){
+    return {GetWriter().Value(value)};
+}
+
+Writer::DictItemContext Writer::ArrayItemContext::StartDict(){
+    return GetWriter().StartDict();
+}
+
+Writer::ArrayItemContext Writer::ArrayItemContext::StartArray(){
+    return GetWriter().StartArray();
+}
+
+Writer& Writer::ArrayItemContext::EndArray(){
+    return GetWriter().EndArray();
+}
+
+} //namespace json
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "json.h"
+
+namespace json {
+
+/*
+ * Потоковая запись JSON: значения сразу выводятся в поток, дерево Node не строится,
+ * и память не зависит от размера документа. Вывод совпадает с json::Print того же
+ * документа в том же PrintFormat, поэтому ключи словаря передаются по алфавиту (иначе logic_error).
+ * Как и у Builder, контексты не дают собрать недопустимую цепочку вызовов,
+ * а остальные ошибки порядка вызовов дают logic_error.
+ */
+class Writer {
+
+    class WriterItemContext;
+    class DictItemContext;
+    class ArrayItemContext;
+    class KeyItemContext;
+
+public:
+    // Значение без вложенных элементов. Как и у Node::Value, тип выбирается без сужающих
+    // преобразований: size_t сначала нужно явно привести к int или double
+    using Scalar = std::variant<std::nullptr_t, bool, int, double, std::string_view>;
+
+private:
+    class WriterItemContext {
+    public:
+        WriterItemContext(Writer& writer);
+        Writer& GetWriter();
+    private:
+        Writer& writer_;
+    };
+
+    class KeyItemContext : public WriterItemContext {
+    public:
+        DictItemContext Value(Scalar value);
+        DictItemContext StartDict();
+        ArrayItemContext StartArray();
+    };
+
+    class DictItemContext : public WriterItemContext {
+    public:
+        KeyItemContext Key(std::string_view key);
+        Writer& EndDict();
+    };
+
+    class ArrayItemContext : public WriterItemContext {
+    public:
+        ArrayItemContext Value(Scalar value);
+        DictItemContext StartDict();
+        ArrayItemContext StartArray();
+        Writer& EndArray();
+    };
+
+public:
+    explicit Writer(std::ostream& out, PrintFormat format = PrintFormat::PRETTY);
+
+    KeyItemContext Key(std::string_view key);
+    Writer& Value(Scalar value);
+    DictItemContext StartDict();
+    ArrayItemContext StartArray();
+    Writer& EndDict();
+    Writer& EndArray();
+
+private:
+    struct Scope {
+        bool is_dict = false;
+        bool has_items = false;
+        // Ключ выведен, его значение — ещё нет
+        bool awaits_value = false;
+        std::string last_key;
+    };
+
+    std::ostream& out_;
+    bool compact_ = false;
+    std::vector<Scope> scopes_;
+    bool has_root_ = false;
+
+    // Разделитель и отступ перед значением; проверяет, что значение здесь допустимо
+    void BeginValue();
+    void PrintSeparator();
+    void PrintLineBreak();
+    void PrintIndent(size_t depth);
+};
+
+} //namespace json
@@ -1,20 +1,124 @@
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include <unistd.h>
+
+#include "catalogue_version.h"
 #include "json_reader.h"
 #include "map_renderer.h"
+#include "mapped_file.h"
+#include "memory_usage.h"
+#include "ndjson.h"
 #include "request_handler.h"
+#include "serialization.h"
+#include "sharded_router.h"
 #include "transport_router.h"
 
-int main() {
-    json::JsonReader json_reader(std::cin); //Превращаем json из потока ввода в document_
+using namespace std::literals;
+
+struct Options {
+    std::optional<std::string> load_catalogue; //Брать справочник из двоичного файла, а не из base_requests
+    std::optional<std::string> save_catalogue; //Сохранить построенный справочник в двоичный файл
+    std::optional<std::string> router_cache; //Файл-кэш таблицы маршрутов
+    bool out_of_core = false; //Читать расстояния из файла справочника по запросу, не загружая их
+    json::PrintFormat output_format = json::PrintFormat::PRETTY; //Оформление выходного JSON
+    bool ndjson = false; //Запросы и ответы потоком, по строке JSON на каждый
+};
+
+std::optional<Options> ParseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--load-catalogue"sv && i + 1 < argc) {
+            options.load_catalogue = argv[++i];
+        } else if (arg == "--save-catalogue"sv && i + 1 < argc) {
+            options.save_catalogue = argv[++i];
+        } else if (arg == "--router-cache"sv && i + 1 < argc) {
+            options.router_cache = argv[++i];
+        } else if (arg == "--out-of-core"sv) {
+            options.out_of_core = true;
+        } else if (arg == "--compact"sv) {
+            options.output_format = json::PrintFormat::COMPACT;
+        } else if (arg == "--ndjson"sv) {
+            options.ndjson = true;
+        } else {
+            return std::nullopt;
+        }
+    }
+    //Вне памяти может лежать только справочник, загруженный из файла
+    if (options.out_of_core && !options.load_catalogue) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+//Весь поток ввода, а в режиме NDJSON — только его первая строка
+json::JsonReader ReadInput(const Options& options) {
+    if (options.ndjson) {
+        std::string line;
+        std::getline(std::cin, line);
+        return json::JsonReader(std::string_view(line));
+    }
+    //Файл, перенаправленный в поток ввода, разбираем прямо из отображённой памяти, не копируя в буфер
+    if (memory::MappedFile::IsMappable(STDIN_FILENO)) {
+        const memory::MappedFile input_file(STDIN_FILENO);
+        return json::JsonReader(std::string_view(reinterpret_cast<const char*>(input_file.GetData().data()), input_file.GetData().size()));
+    }
+    return json::JsonReader(std::cin);
+}
+
+int main(int argc, char* argv[]) {
+    const std::optional<Options> options = ParseOptions(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: "sv << argv[0] << " [--load-catalogue FILE] [--save-catalogue FILE] [--router-cache FILE] [--out-of-core] [--compact] [--ndjson]"sv << std::endl;
+        return 1;
+    }
+
+    json::JsonReader json_reader = ReadInput(*options); //Превращаем json из потока ввода в document_
+    if (json_reader.HasRegions()) {
+        //Несколько регионов: у каждого свой справочник и маршрутизатор, карта не строится
+        if (options->load_catalogue || options->save_catalogue || options->router_cache || options->ndjson) {
+            std::cerr << "Catalogue and router cache files and NDJSON are not supported for regions"sv << std::endl;
+            return 1;
+        }
+        const std::vector<routing::Shard> shards = json_reader.MakeRegionDBs();
+        routing::ShardedRouter sharded_router(shards, json_reader.ParseRoutingSettings());
+        json_reader.PrintShardedJson(std::cout, sharded_router, options->output_format);
+        return 0;
+    }
     renderer::MapRenderer map_renderer(json_reader.ParseRenderSettings()); //Применяем настройки отрисовки
-    StatRequestHandler handler(json_reader.MakeDB(), map_renderer); //Создаем обработчик запросов
+    const TransportCatalogue& db = options->load_catalogue
+        ? json_reader.LoadDB(*options->load_catalogue, options->out_of_core) //Справочник из двоичного файла
+        : json_reader.MakeDB(); //Справочник из base_requests
+    if (options->save_catalogue) {
+        serialization::SaveCatalogue(db, *options->save_catalogue);
+    }
     routing::RoutingSettings routing_settings(json_reader.ParseRoutingSettings()); //Парсинг настроек маршрутов
-    routing::TransportRouter transport_router(json_reader.GetDB(), routing_settings); //Создание маршрутизатора
+    if (options->ndjson) {
+        //Справочник, маршрутизатор и карта живут в версиях, которые сменяют друг друга при дополнении справочника
+        auto first_version = std::make_shared<const CatalogueVersion>(json_reader.ReleaseDB(), routing_settings, options->router_cache,
+                                                                      map_renderer, json_reader.GetDocumentMemoryUsage());
+        memory::PrintSummary(std::cerr, first_version->memory_reports);
+        std::cerr << std::endl;
+        CatalogueVersions versions(std::move(first_version));
+        RunNdjson(std::cin, std::cout, json_reader, versions, map_renderer);
+        return 0;
+    }
+    StatRequestHandler handler(db, map_renderer); //Создаем обработчик запросов
+    //Создание маршрутизатора
+    routing::TransportRouter transport_router = options->router_cache
+        ? routing::TransportRouter(db, routing_settings, *options->router_cache)
+        : routing::TransportRouter(db, routing_settings);
     auto map = handler.RenderMap(); //Обработчик генерирует карту
     std::ostringstream map_output;
     map.Render(map_output); //Отрисовка карты и вывод в строковый поток
-    json_reader.PrintJson(std::cout, transport_router, map_output.str()); //Формирование выходного json документа с картой
+    const memory::Reports memory_reports = MakeMemoryReports(db, transport_router, json_reader.GetDocumentMemoryUsage(), map);
+    memory::PrintSummary(std::cerr, memory_reports);
+    std::cerr << std::endl;
+    json_reader.PrintJson(std::cout, transport_router, map_output.view(), memory_reports, options->output_format); //Формирование выходного json документа с картой
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace memory {
+
+using namespace std::literals;
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open "s + path);
+    }
+    try {
+        Map(fd, path);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    //Отображение остаётся действительным и после закрытия дескриптора
+    close(fd);
+}
+
+MappedFile::MappedFile(int fd) {
+    Map(fd, "descriptor "s + std::to_string(fd));
+}
+
+bool MappedFile::IsMappable(int fd) {
+    struct stat file_stat{};
+    return fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode);
+}
+
+void MappedFile::Map(int fd, const std::string& name) {
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) != 0) {
+        throw std::runtime_error("Failed to stat "s + name);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ > 0) {
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("Failed to map "s + name);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+}
+
+std::span<const std::byte> MappedFile::GetData() const {
+    return {static_cast<const std::byte*>(data_), size_};
+}
+
+void MappedFile::AdviseRandomAccess(size_t offset, size_t size) const {
+    if (data_ == nullptr || size == 0) {
+        return;
+    }
+    //madvise принимает только адреса, выровненные на страницу
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = offset / page_size * page_size;
+    madvise(static_cast<char*>(data_) + begin, offset + size - begin, MADV_RANDOM);
+}
+
+} // namespace memory
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace memory {
+
+/*
+ * Файл, отображённый в память только для чтения.
+ * Страницы подгружаются операционной системой по мере обращения к ним.
+ */
+class MappedFile {
+public:
+    // Бросает std::runtime_error, если файл не удалось открыть или отобразить
+    explicit MappedFile(const std::string& path);
+    // Отображает уже открытый файл; дескриптор остаётся открытым
+    explicit MappedFile(int fd);
+    // Дескриптор указывает на обычный файл, а не на канал или терминал
+    static bool IsMappable(int fd);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> GetData() const;
+    // Подсказка системе: к участку обращаются вразнобой, упреждающее чтение соседних страниц не нужно
+    void AdviseRandomAccess(size_t offset, size_t size) const;
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+
+    // name — для сообщений об ошибках
+    void Map(int fd, const std::string& name);
+};
+
+} // namespace memory
@@ -0,0 +1,35 @@
+#include "memory_usage.h"
+
+namespace memory {
+
+using namespace std::literals;
+
+void Report::Add(std::string name, Usage usage) {
+    parts.emplace_back(std::move(name), usage);
+}
+
+void Report::Add(const std::string& prefix, const Report& nested) {
+    for (const auto& [name, usage] : nested.parts) {
+        Add(prefix + "."s + name, usage);
+    }
+}
+
+size_t Report::GetTotalBytes() const {
+    size_t bytes = 0;
+    for (const auto& [name, usage] : parts) {
+        bytes += usage.bytes;
+    }
+    return bytes;
+}
+
+void PrintSummary(std::ostream& out, const Reports& reports) {
+    size_t total_bytes = 0;
+    out << "Memory usage:"sv;
+    for (const auto& [name, report] : reports) {
+        out << ' ' << name << '=' << report.GetTotalBytes();
+        total_bytes += report.GetTotalBytes();
+    }
+    out << " total="sv << total_bytes << " bytes"sv;
+}
+
+} // namespace memory
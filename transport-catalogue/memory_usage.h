@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace memory {
+
+// Память части структуры: байты в куче и число элементов
+struct Usage {
+    size_t bytes = 0;
+    size_t items = 0;
+
+    Usage& operator+=(const Usage& other) {
+        bytes += other.bytes;
+        items += other.items;
+        return *this;
+    }
+};
+
+// Память компонента по его частям, в порядке добавления
+struct Report {
+    std::vector<std::pair<std::string, Usage>> parts;
+
+    void Add(std::string name, Usage usage);
+    // Добавляет части вложенного отчёта под именами "prefix.часть"
+    void Add(const std::string& prefix, const Report& nested);
+    // Байты — сумма по частям; элементы не суммируются, у частей они разного рода
+    size_t GetTotalBytes() const;
+};
+
+// Отчёты компонентов программы по их именам
+using Reports = std::vector<std::pair<std::string, Report>>;
+
+// Одна строка для журнала: байты каждого компонента и всего
+void PrintSummary(std::ostream& out, const Reports& reports);
+
+/*
+ * Оценки памяти стандартных контейнеров по их устройству в libstdc++ (64 бита).
+ * Учитываются массивы, узлы и служебные поля узлов, но не накладные расходы
+ * распределителя и не память, на которую ссылаются сами элементы.
+ */
+template <typename T>
+size_t GetHeapBytes(const std::vector<T>& vec) {
+    return vec.capacity() * sizeof(T);
+}
+
+template <typename Char>
+size_t GetHeapBytes(const std::basic_string<Char>& str) {
+    //Короткие строки хранятся внутри объекта
+    constexpr size_t LOCAL_CAPACITY = 15 / sizeof(Char);
+    return str.capacity() > LOCAL_CAPACITY ? (str.capacity() + 1) * sizeof(Char) : 0;
+}
+
+template <typename T>
+size_t GetHeapBytes(const std::deque<T>& deq) {
+    //Элементы лежат в блоках по 512 байт, на блоки указывает отдельный массив
+    constexpr size_t ITEMS_PER_BLOCK = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+    const size_t blocks = deq.size() / ITEMS_PER_BLOCK + 1;
+    return blocks * ITEMS_PER_BLOCK * sizeof(T) + std::max<size_t>(8, blocks + 2) * sizeof(void*);
+}
+
+template <typename Key, typename Value, typename Hash, typename Equal>
+size_t GetHeapBytes(const std::unordered_map<Key, Value, Hash, Equal>& map) {
+    //Узел: указатель на следующий, элемент и сохранённый хэш
+    constexpr size_t NODE_BYTES = sizeof(void*) + sizeof(std::pair<const Key, Value>) + sizeof(size_t);
+    return map.size() * NODE_BYTES + map.bucket_count() * sizeof(void*);
+}
+
+template <typename Key, typename Hash, typename Equal>
+size_t GetHeapBytes(const std::unordered_set<Key, Hash, Equal>& set) {
+    constexpr size_t NODE_BYTES = sizeof(void*) + sizeof(Key) + sizeof(size_t);
+    return set.size() * NODE_BYTES + set.bucket_count() * sizeof(void*);
+}
+
+//Узел красно-чёрного дерева: цвет и три указателя
+inline constexpr size_t TREE_NODE_HEADER_BYTES = 4 * sizeof(void*);
+
+template <typename Key, typename Compare>
+size_t GetHeapBytes(const std::set<Key, Compare>& set) {
+    return set.size() * (TREE_NODE_HEADER_BYTES + sizeof(Key));
+}
+
+template <typename Key, typename Value, typename Compare>
+size_t GetHeapBytes(const std::map<Key, Value, Compare>& map) {
+    return map.size() * (TREE_NODE_HEADER_BYTES + sizeof(std::pair<const Key, Value>));
+}
+
+} // namespace memory
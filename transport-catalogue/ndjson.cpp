@@ -0,0 +1,63 @@
+#include "ndjson.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "json_writer.h"
+
+using namespace std::literals;
+
+void RunNdjson(std::istream& in, std::ostream& out, const json::JsonReader& json_reader,
+               CatalogueVersions& versions, renderer::MapRenderer& renderer) {
+    const auto print_line = [&out](std::string_view response) {
+        out << response << std::endl;
+    };
+    const auto print_error = [&print_line](std::string_view message) {
+        std::ostringstream response;
+        json::Writer(response, json::PrintFormat::COMPACT).StartDict().Key("error_message"sv).Value(message).EndDict();
+        print_line(response.view());
+    };
+    //Ответ собирается в буфере, чтобы ошибка посреди ответа не оставила в выводе его начало
+    const auto answer = [&](const json::Node& request) {
+        const CatalogueVersions::Snapshot version = versions.Acquire();
+        std::ostringstream response;
+        try {
+            json_reader.PrintResponse(response, request, version->db, version->router, version->map,
+                                      version->memory_reports, json::PrintFormat::COMPACT);
+        } catch (const std::exception& e) {
+            print_error(e.what());
+            return;
+        }
+        print_line(response.view());
+    };
+
+    for (const json::Node& request : json_reader.GetStatRequests()) {
+        answer(request);
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r"sv) == std::string::npos) {
+            continue;
+        }
+        try {
+            const json::Document document = json::Load(std::string_view(line));
+            const json::Dict& request = document.GetRoot().AsMap();
+            const auto base_requests = request.find("base_requests"sv);
+            if (base_requests == request.end()) {
+                answer(document.GetRoot());
+                continue;
+            }
+            json::BaseRequestsData delta;
+            for (const json::Node& base_request : base_requests->second.AsArray()) {
+                delta.Add(base_request.AsMap());
+            }
+            versions.Update([&delta, &renderer](const CatalogueVersion& current) {
+                return std::make_shared<const CatalogueVersion>(current, delta.GetData(), renderer);
+            });
+        } catch (const std::exception& e) {
+            print_error(e.what());
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+
+#include "catalogue_version.h"
+#include "json_reader.h"
+#include "map_renderer.h"
+
+/*
+ * Режим NDJSON: на каждый запрос stat_requests документа json_reader, а затем на каждую
+ * строку in выводится одна строка ответа в out — сразу, как только он готов.
+ * Строка вида {"base_requests": [...]} строит по текущей версии справочника следующую
+ * и публикует её в versions; ответа она не получает. Каждый запрос берёт текущую версию
+ * один раз и отвечает целиком по ней, даже если тем временем опубликована новая.
+ * Ошибка в строке даёт ответ {"error_message": ...}, после чего чтение продолжается.
+ * Пакет base_requests с ошибкой отклоняется целиком: недостроенная версия не публикуется
+ */
+void RunNdjson(std::istream& in, std::ostream& out, const json::JsonReader& json_reader,
+               CatalogueVersions& versions, renderer::MapRenderer& renderer);
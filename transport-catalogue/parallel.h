@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+// Меньше этого числа элементов на поток запускать потоки невыгодно
+inline constexpr size_t MIN_ITEMS_PER_THREAD = 256;
+
+// Вызывает func(i) для всех i из [0, count), распределяя диапазон по ядрам процессора.
+// func не должна изменять общие данные без синхронизации.
+// Первое исключение, брошенное в одном из потоков, пробрасывается вызывающему.
+template <typename Func>
+void For(size_t count, Func func) {
+    const size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t threads_count = std::min(hardware_threads, count / MIN_ITEMS_PER_THREAD);
+    if (threads_count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    const size_t chunk_size = (count + threads_count - 1) / threads_count;
+    std::vector<std::exception_ptr> errors(threads_count);
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count);
+    for (size_t thread_id = 0; thread_id < threads_count; ++thread_id) {
+        threads.emplace_back([&func, &errors, thread_id, chunk_size, count] {
+            try {
+                const size_t end = std::min(count, (thread_id + 1) * chunk_size);
+                for (size_t i = thread_id * chunk_size; i < end; ++i) {
+                    func(i);
+                }
+            } catch (...) {
+                errors[thread_id] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace parallel
@@ -30,8 +30,10 @@ std::optional<BusInfo> StatRequestHandler::GetBusInfo(const std::string_view& bu
 const std::unordered_set<const Bus*> StatRequestHandler::GetBusesByStop(const std::string_view& stop_name) const {
     std::unordered_set<const Bus*> result;
     auto buses = db_.GetBuses();
-    for (auto bus_name : db_.GetBusesOnStop(stop_name)){
-        result.insert(buses.at(bus_name));
+    if (const auto bus_names = db_.GetBusesOnStop(stop_name)) {
+        for (auto bus_name : *bus_names){
+            result.insert(buses.at(bus_name));
+        }
     }
     return result;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <iterator>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
@@ -20,7 +21,15 @@ private:
     using Graph = DirectedWeightedGraph<Weight>;
 
 public:
+    struct RouteInternalData {
+        Weight weight;
+        std::optional<EdgeId> prev_edge;
+    };
+    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+
     explicit Router(const Graph& graph);
+    // Восстанавливает маршрутизатор по ранее посчитанным для этого же графа данным, без пересчёта
+    Router(const Graph& graph, RoutesInternalData routes_internal_data);
 
     struct RouteInfo {
         Weight weight;
@@ -28,13 +37,16 @@ public:
     };
 
     std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    const RoutesInternalData& GetRoutesInternalData() const;
+    // Таблица маршрутов; элементы — её ячейки
+    memory::Usage GetMemoryUsage() const;
+
+    // Дополняет таблицу вершинами и рёбрами, добавленными в граф после построения,
+    // и учитывает уменьшение весов рёбер decreased_edges. Веса остальных рёбер меняться
+    // не должны. Каждое новое или подешевевшее ребро обходится в O(V^2)
+    void Update(std::span<const EdgeId> decreased_edges = {});
 
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
 
     void InitializeRoutesInternalData(const Graph& graph) {
         const size_t vertex_count = graph.GetVertexCount();
@@ -75,9 +87,40 @@ private:
         }
     }
 
+    void AddVertices(size_t vertex_count) {
+        const size_t old_vertex_count = routes_internal_data_.size();
+        for (auto& routes_from : routes_internal_data_) {
+            routes_from.resize(vertex_count);
+        }
+        routes_internal_data_.resize(vertex_count, std::vector<std::optional<RouteInternalData>>(vertex_count));
+        for (VertexId vertex = old_vertex_count; vertex < vertex_count; ++vertex) {
+            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+        }
+    }
+
+    // Новое ребро может сократить только маршруты вида from -> edge.from -> edge.to -> to
+    void RelaxRoutesInternalDataThroughEdge(size_t vertex_count, EdgeId edge_id) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            if (const auto& route_from = routes_internal_data_[vertex_from][edge.from]) {
+                const RouteInternalData route_through_edge{route_from->weight + edge.weight, edge_id};
+                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                    if (const auto& route_to = routes_internal_data_[edge.to][vertex_to]) {
+                        RelaxRoute(vertex_from, vertex_to, route_through_edge, *route_to);
+                    }
+                }
+            }
+        }
+    }
+
     static constexpr Weight ZERO_WEIGHT{};
     const Graph& graph_;
     RoutesInternalData routes_internal_data_;
+    // Число рёбер графа, уже учтённых в таблице
+    size_t edge_count_ = 0;
 };
 
 template <typename Weight>
@@ -85,6 +128,7 @@ Router<Weight>::Router(const Graph& graph)
     : graph_(graph)
     , routes_internal_data_(graph.GetVertexCount(),
                             std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+    , edge_count_(graph.GetEdgeCount())
 {
     InitializeRoutesInternalData(graph);
 
@@ -94,6 +138,46 @@ Router<Weight>::Router(const Graph& graph)
     }
 }
 
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, RoutesInternalData routes_internal_data)
+    : graph_(graph)
+    , routes_internal_data_(std::move(routes_internal_data))
+    , edge_count_(graph.GetEdgeCount())
+{
+    assert(routes_internal_data_.size() == graph.GetVertexCount());
+}
+
+template <typename Weight>
+const typename Router<Weight>::RoutesInternalData& Router<Weight>::GetRoutesInternalData() const {
+    return routes_internal_data_;
+}
+
+template <typename Weight>
+memory::Usage Router<Weight>::GetMemoryUsage() const {
+    memory::Usage usage{memory::GetHeapBytes(routes_internal_data_), 0};
+    for (const auto& routes_from : routes_internal_data_) {
+        usage.bytes += memory::GetHeapBytes(routes_from);
+        usage.items += routes_from.size();
+    }
+    return usage;
+}
+
+template <typename Weight>
+void Router<Weight>::Update(std::span<const EdgeId> decreased_edges) {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (vertex_count > routes_internal_data_.size()) {
+        AddVertices(vertex_count);
+    }
+    // Подешевевшее ребро — то же, что новое ребро с меньшим весом: прежние маршруты через него
+    // дороже любого маршрута через его новый вес и будут заменены
+    for (const EdgeId edge_id : decreased_edges) {
+        RelaxRoutesInternalDataThroughEdge(vertex_count, edge_id);
+    }
+    for (; edge_count_ < graph_.GetEdgeCount(); ++edge_count_) {
+        RelaxRoutesInternalDataThroughEdge(vertex_count, edge_count_);
+    }
+}
+
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
                                                                              VertexId to) const {
@@ -0,0 +1,444 @@
+#include "serialization.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+#include "mapped_file.h"
+
+namespace serialization {
+
+using namespace std::literals;
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'C', 'A', 'T', 'A', 'L', 'O', 'G'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t ALIGNMENT = 8;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t stops_count;
+    uint64_t distances_count;
+    uint64_t buses_count;
+    uint64_t bus_stops_count;
+    uint64_t names_size;
+};
+
+struct StopRecord {
+    uint64_t name_offset;
+    uint32_t name_size;
+    uint32_t distances_count;
+    double lat;
+    double lng;
+};
+
+struct DistanceRecord {
+    uint32_t to;
+    int32_t distance;
+};
+
+struct BusRecord {
+    uint64_t name_offset;
+    uint32_t name_size;
+    uint32_t is_circle;
+    uint64_t stops_begin;
+    uint64_t stops_count;
+};
+
+size_t Align(size_t size) {
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+// Смещения секций от начала файла; последний элемент — полный размер файла
+struct Layout {
+    size_t stops;
+    size_t distances;
+    size_t buses;
+    size_t bus_stops;
+    size_t names;
+    size_t end;
+};
+
+// Раскладывает секции по файлу размера file_size; nullopt, если они в нём не помещаются.
+// Число элементов каждой секции сравнивается с оставшимся местом через деление, поэтому
+// ни произведения, ни суммы не переполняются даже при испорченном заголовке
+std::optional<Layout> ComputeLayout(const Header& header, size_t file_size) {
+    Layout layout{};
+    size_t offset = sizeof(Header);
+    const auto place = [&offset, file_size](size_t& section, uint64_t count, size_t item_size) {
+        section = offset;
+        if (count > (file_size - offset) / item_size) {
+            return false;
+        }
+        const size_t size = Align(count * item_size);
+        if (size > file_size - offset) {
+            return false;
+        }
+        offset += size;
+        return true;
+    };
+    if (!place(layout.stops, header.stops_count, sizeof(StopRecord))
+        || !place(layout.distances, header.distances_count, sizeof(DistanceRecord))
+        || !place(layout.buses, header.buses_count, sizeof(BusRecord))
+        || !place(layout.bus_stops, header.bus_stops_count, sizeof(uint32_t))) {
+        return std::nullopt;
+    }
+    //Таблица имён последняя и не выравнивается
+    layout.names = offset;
+    if (header.names_size > file_size - offset) {
+        return std::nullopt;
+    }
+    layout.end = offset + header.names_size;
+    return layout;
+}
+
+template <typename T>
+void WriteArray(std::ostream& out, const std::vector<T>& items) {
+    out.write(reinterpret_cast<const char*>(items.data()), static_cast<std::streamsize>(items.size() * sizeof(T)));
+}
+
+void WritePadding(std::ostream& out, size_t written) {
+    static constexpr char ZEROS[ALIGNMENT] = {};
+    out.write(ZEROS, static_cast<std::streamsize>(Align(written) - written));
+}
+
+template <typename T>
+const T* SectionAt(std::span<const std::byte> bytes, size_t offset) {
+    return reinterpret_cast<const T*>(bytes.data() + offset);
+}
+
+// Расстояния, которые читаются прямо из отображённого файла. В памяти держатся только
+// начала списков смежности; остановку узнаём по адресу её имени в таблице имён
+class MappedDistanceTable : public DistanceTable {
+public:
+    MappedDistanceTable(std::shared_ptr<const memory::MappedFile> file, const Header& header, const Layout& layout)
+    : file_(std::move(file))
+    , stops_(SectionAt<StopRecord>(file_->GetData(), layout.stops), header.stops_count)
+    , distances_(SectionAt<DistanceRecord>(file_->GetData(), layout.distances), header.distances_count)
+    , names_(SectionAt<char>(file_->GetData(), layout.names), header.names_size)
+    , row_begins_(header.stops_count + 1, 0)
+    {
+        for (size_t i = 0; i < stops_.size(); ++i) {
+            row_begins_[i + 1] = row_begins_[i] + stops_[i].distances_count;
+            if (row_begins_[i + 1] > distances_.size()) {
+                throw FormatError("Distance list is out of range"s);
+            }
+        }
+    }
+
+    std::optional<int> Find(std::string_view from, std::string_view to) const override {
+        const std::optional<uint32_t> from_id = FindStopId(from);
+        const std::optional<uint32_t> to_id = FindStopId(to);
+        if (!from_id || !to_id) {
+            return std::nullopt;
+        }
+        const std::span<const DistanceRecord> row = GetRow(*from_id);
+        const auto it = std::lower_bound(row.begin(), row.end(), *to_id, [](const DistanceRecord& record, uint32_t id) {
+            return record.to < id;
+        });
+        if (it == row.end() || it->to != *to_id) {
+            return std::nullopt;
+        }
+        return it->distance;
+    }
+
+    void ForEachFrom(std::string_view from, const std::function<void(std::string_view to, int distance)>& visitor) const override {
+        const std::optional<uint32_t> from_id = FindStopId(from);
+        if (!from_id) {
+            return;
+        }
+        for (const DistanceRecord& record : GetRow(*from_id)) {
+            if (record.to >= stops_.size()) {
+                throw FormatError("Unknown stop id in distances"s);
+            }
+            visitor(GetName(record.to), record.distance);
+        }
+    }
+
+    size_t GetSize() const override {
+        return distances_.size();
+    }
+
+private:
+    std::shared_ptr<const memory::MappedFile> file_;
+    std::span<const StopRecord> stops_;
+    std::span<const DistanceRecord> distances_;
+    std::string_view names_;
+    std::vector<uint64_t> row_begins_;
+
+    std::span<const DistanceRecord> GetRow(uint32_t stop_id) const {
+        return distances_.subspan(row_begins_[stop_id], row_begins_[stop_id + 1] - row_begins_[stop_id]);
+    }
+
+    std::string_view GetName(uint32_t stop_id) const {
+        return names_.substr(stops_[stop_id].name_offset, stops_[stop_id].name_size);
+    }
+
+    std::optional<uint32_t> FindStopId(std::string_view name) const {
+        const auto address = reinterpret_cast<uintptr_t>(name.data());
+        const auto names_address = reinterpret_cast<uintptr_t>(names_.data());
+        if (address < names_address || address > names_address + names_.size()) {
+            return std::nullopt;
+        }
+        //Имена остановок записаны в таблицу первыми, в порядке номеров остановок
+        const std::pair<uint64_t, uint32_t> key{address - names_address, static_cast<uint32_t>(name.size())};
+        const auto it = std::lower_bound(stops_.begin(), stops_.end(), key, [](const StopRecord& record, const auto& key) {
+            return std::pair(record.name_offset, record.name_size) < key;
+        });
+        if (it == stops_.end() || std::pair(it->name_offset, it->name_size) != key) {
+            return std::nullopt;
+        }
+        return static_cast<uint32_t>(it - stops_.begin());
+    }
+};
+
+} // namespace
+
+void SaveCatalogue(const TransportCatalogue& db, const std::string& path) {
+    std::string names;
+    auto add_name = [&names](std::string_view name) {
+        const uint64_t offset = names.size();
+        names.append(name);
+        return std::pair{offset, static_cast<uint32_t>(name.size())};
+    };
+
+    //Остановки пишем в порядке добавления, чтобы после загрузки порядок обхода совпал
+    const std::vector<const Stop*> stops(db.GetStopsList().rbegin(), db.GetStopsList().rend());
+    std::unordered_map<std::string_view, uint32_t> stop_ids;
+    stop_ids.reserve(stops.size());
+    for (const Stop* stop : stops) {
+        stop_ids.emplace(stop->name, static_cast<uint32_t>(stop_ids.size()));
+    }
+
+    //Таблица расстояний может не помещаться в память (см. MapCatalogue), поэтому её обходят
+    //дважды: сначала считают длины списков смежности, затем пишут списки по одному
+    std::vector<uint32_t> distances_counts(stops.size(), 0);
+    uint64_t distances_count = 0;
+    db.ForEachDistance([&stop_ids, &distances_counts, &distances_count](const Distance& distance) {
+        ++distances_counts[stop_ids.at(distance.from)];
+        ++distances_count;
+    });
+
+    std::vector<StopRecord> stop_records;
+    stop_records.reserve(stops.size());
+    for (size_t i = 0; i < stops.size(); ++i) {
+        const auto [name_offset, name_size] = add_name(stops[i]->name);
+        stop_records.push_back({name_offset, name_size, distances_counts[i],
+                                stops[i]->coordinates.lat, stops[i]->coordinates.lng});
+    }
+
+    std::vector<BusRecord> bus_records;
+    std::vector<uint32_t> bus_stops;
+    for (const auto& [bus_name, bus] : db.GetBuses()) {
+        const auto [name_offset, name_size] = add_name(bus_name);
+        bus_records.push_back({name_offset, name_size, bus->is_circle, bus_stops.size(), bus->stops.size()});
+        for (std::string_view stop_name : bus->stops) {
+            bus_stops.push_back(stop_ids.at(stop_name));
+        }
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.stops_count = stop_records.size();
+    header.distances_count = distances_count;
+    header.buses_count = bus_records.size();
+    header.bus_stops_count = bus_stops.size();
+    header.names_size = names.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to open "s + path + " for writing"s);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WriteArray(out, stop_records);
+    //ForEachDistance группирует расстояния по начальной остановке в порядке добавления,
+    //то есть в порядке номеров остановок в файле
+    std::vector<DistanceRecord> row;
+    uint32_t row_stop_id = 0;
+    const auto write_row = [&out, &row]() {
+        std::sort(row.begin(), row.end(), [](const DistanceRecord& lhs, const DistanceRecord& rhs) {
+            return lhs.to < rhs.to;
+        });
+        WriteArray(out, row);
+        row.clear();
+    };
+    db.ForEachDistance([&](const Distance& distance) {
+        const uint32_t from_id = stop_ids.at(distance.from);
+        if (from_id != row_stop_id) {
+            write_row();
+            row_stop_id = from_id;
+        }
+        row.push_back({stop_ids.at(distance.to), distance.distance});
+    });
+    write_row();
+    WriteArray(out, bus_records);
+    WriteArray(out, bus_stops);
+    WritePadding(out, bus_stops.size() * sizeof(uint32_t));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    if (!out) {
+        throw std::runtime_error("Failed to write "s + path);
+    }
+}
+
+namespace {
+
+// distances_in_file — расстояния не загружать в справочник, а читать из файла по запросу
+void LoadMappedCatalogue(const std::string& path, TransportCatalogue& db, bool distances_in_file) {
+    auto file = std::make_shared<const memory::MappedFile>(path);
+    const std::span<const std::byte> bytes = file->GetData();
+
+    Header header{};
+    if (bytes.size() < sizeof(Header)) {
+        throw FormatError("File is too short: "s + path);
+    }
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw FormatError("Not a catalogue file: "s + path);
+    }
+    if (header.version != VERSION) {
+        throw FormatError("Unsupported catalogue format version "s + std::to_string(header.version));
+    }
+    const std::optional<Layout> layout = ComputeLayout(header, bytes.size());
+    if (!layout || layout->end != bytes.size()) {
+        throw FormatError("Catalogue file size mismatch: "s + path);
+    }
+
+    const char* names = SectionAt<char>(bytes, layout->names);
+    auto get_name = [names, &header](uint64_t offset, uint32_t size) {
+        if (offset > header.names_size || size > header.names_size - offset) {
+            throw FormatError("Name is out of the name table"s);
+        }
+        return std::string_view(names + offset, size);
+    };
+
+    CatalogueData data;
+    data.stops.reserve(header.stops_count);
+    data.distances.reserve(header.distances_count);
+    data.buses.reserve(header.buses_count);
+
+    const StopRecord* stop_records = SectionAt<StopRecord>(bytes, layout->stops);
+    for (size_t i = 0; i < header.stops_count; ++i) {
+        const StopRecord& record = stop_records[i];
+        data.stops.push_back({get_name(record.name_offset, record.name_size), {record.lat, record.lng}, {}});
+    }
+
+    const DistanceRecord* distance_records = SectionAt<DistanceRecord>(bytes, layout->distances);
+    size_t distance_pos = 0;
+    for (size_t i = 0; i < header.stops_count && !distances_in_file; ++i) {
+        if (stop_records[i].distances_count > header.distances_count - distance_pos) {
+            throw FormatError("Distance list is out of range"s);
+        }
+        for (uint32_t j = 0; j < stop_records[i].distances_count; ++j, ++distance_pos) {
+            const DistanceRecord& record = distance_records[distance_pos];
+            if (record.to >= header.stops_count) {
+                throw FormatError("Unknown stop id in distances"s);
+            }
+            data.distances.push_back({data.stops[i].name, data.stops[record.to].name, record.distance});
+        }
+    }
+
+    const uint32_t* bus_stop_ids = SectionAt<uint32_t>(bytes, layout->bus_stops);
+    std::vector<std::string_view> bus_stops(header.bus_stops_count);
+    for (size_t i = 0; i < header.bus_stops_count; ++i) {
+        if (bus_stop_ids[i] >= header.stops_count) {
+            throw FormatError("Unknown stop id in bus route"s);
+        }
+        bus_stops[i] = data.stops[bus_stop_ids[i]].name;
+    }
+
+    const BusRecord* bus_records = SectionAt<BusRecord>(bytes, layout->buses);
+    for (size_t i = 0; i < header.buses_count; ++i) {
+        const BusRecord& record = bus_records[i];
+        if (record.stops_begin > header.bus_stops_count || record.stops_count > header.bus_stops_count - record.stops_begin) {
+            throw FormatError("Bus route is out of range"s);
+        }
+        data.buses.push_back({
+            get_name(record.name_offset, record.name_size),
+            std::span<const std::string_view>(bus_stops).subspan(record.stops_begin, record.stops_count),
+            0,
+            record.is_circle != 0
+        });
+    }
+
+    if (distances_in_file) {
+        file->AdviseRandomAccess(layout->distances, header.distances_count * sizeof(DistanceRecord));
+        auto distances = std::make_shared<const MappedDistanceTable>(file, header, *layout);
+        db.Load(data, std::move(file), std::move(distances));
+    } else {
+        db.Load(data, std::move(file));
+    }
+}
+
+} // namespace
+
+void LoadCatalogue(const std::string& path, TransportCatalogue& db) {
+    LoadMappedCatalogue(path, db, false);
+}
+
+void MapCatalogue(const std::string& path, TransportCatalogue& db) {
+    LoadMappedCatalogue(path, db, true);
+}
+
+void Hasher::Add(std::string_view str) {
+    Add(str.size());
+    AddBytes(str.data(), str.size());
+}
+
+uint64_t Hasher::GetHash() const {
+    return hash_;
+}
+
+void Hasher::AddBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash_ = (hash_ ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+uint64_t ComputeCatalogueHash(const TransportCatalogue& db) {
+    Hasher hasher;
+    hasher.Add(db.GetStopsList().size());
+    for (const Stop* stop : db.GetStopsList()) {
+        hasher.Add(stop->name);
+        hasher.Add(stop->coordinates.lat);
+        hasher.Add(stop->coordinates.lng);
+    }
+
+    //Сумма хешей отдельных расстояний не зависит от порядка обхода,
+    //поэтому расстояния не нужно собирать и сортировать
+    uint64_t distances_hash = 0;
+    size_t distances_count = 0;
+    db.ForEachDistance([&distances_hash, &distances_count](const Distance& distance) {
+        Hasher distance_hasher;
+        distance_hasher.Add(distance.from);
+        distance_hasher.Add(distance.to);
+        distance_hasher.Add(distance.distance);
+        distances_hash += distance_hasher.GetHash();
+        ++distances_count;
+    });
+    hasher.Add(distances_count);
+    hasher.Add(distances_hash);
+
+    const auto buses = db.GetBuses();
+    hasher.Add(buses.size());
+    for (const auto& [bus_name, bus] : buses) {
+        hasher.Add(bus_name);
+        hasher.Add(bus->is_circle);
+        hasher.Add(bus->stops.size());
+        for (std::string_view stop_name : bus->stops) {
+            hasher.Add(stop_name);
+        }
+    }
+    return hasher.GetHash();
+}
+
+} // namespace serialization
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "transport_catalogue.h"
+
+namespace serialization {
+
+class FormatError : public std::runtime_error {
+public:
+    using runtime_error::runtime_error;
+};
+
+/*
+ * Компактный двоичный формат справочника (версия 1, порядок байт платформы):
+ *   заголовок — сигнатура, версия и размеры секций;
+ *   остановки — смещение имени, координаты и число заданных от неё расстояний;
+ *   расстояния — списки смежности остановок подряд: номер остановки назначения и длина;
+ *   маршруты — смещение имени, признак кольца и диапазон в общем массиве остановок маршрутов;
+ *   остановки маршрутов — номера остановок;
+ *   таблица имён — все имена подряд без разделителей.
+ * Все секции выровнены на 8 байт, поэтому файл читается прямо из отображённой памяти.
+ */
+void SaveCatalogue(const TransportCatalogue& db, const std::string& path);
+
+// Отображает файл в память и загружает из него справочник в пустой db.
+// Имена остановок и маршрутов не копируются: справочник ссылается прямо на страницы файла.
+// Бросает FormatError, если файл повреждён или записан другой версией формата
+void LoadCatalogue(const std::string& path, TransportCatalogue& db);
+
+// То же для сетей, не помещающихся в память: дорожные расстояния не загружаются,
+// справочник читает их прямо из файла. В памяти остаются записи остановок и маршрутов
+// и индексы, страницы расстояний подгружаются по обращению и вытесняются системой
+void MapCatalogue(const std::string& path, TransportCatalogue& db);
+
+// Хеш FNV-1a для отпечатков содержимого файлов-кэшей
+class Hasher {
+public:
+    void Add(std::string_view str);
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    void Add(T value) {
+        AddBytes(&value, sizeof(value));
+    }
+
+    uint64_t GetHash() const;
+
+private:
+    uint64_t hash_ = 14695981039346656037ull;
+
+    void AddBytes(const void* data, size_t size);
+};
+
+// Отпечаток содержимого справочника: остановки в порядке обхода, расстояния и маршруты
+uint64_t ComputeCatalogueHash(const TransportCatalogue& db);
+
+} // namespace serialization
@@ -0,0 +1,185 @@
+#include "sharded_router.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace routing {
+
+namespace {
+
+using namespace std::literals;
+
+constexpr double NO_TIME = std::numeric_limits<double>::infinity();
+
+} // namespace
+
+ShardedRouter::ShardedRouter(const std::vector<Shard>& shards, const RoutingSettings& settings)
+: shard_boundaries_(shards.size())
+{
+    for (size_t shard = 0; shard < shards.size(); ++shard) {
+        routers_.emplace_back(shards[shard].db, settings);
+        for (const Stop* stop : shards[shard].db.GetStopsList()) {
+            stop_shards_[stop->name].push_back(shard);
+        }
+        for (std::string_view name : shards[shard].boundary_stops) {
+            const Stop* stop = shards[shard].db.FindStop(name);
+            if (stop == nullptr) {
+                throw std::invalid_argument("Boundary stop "s + std::string(name)
+                                            + " is not in region "s + std::string(shards[shard].name));
+            }
+            const auto [it, inserted] = boundary_ids_.emplace(stop->name, boundary_stops_.size());
+            if (inserted) {
+                boundary_stops_.push_back(stop->name);
+            }
+            shard_boundaries_[shard].push_back(it->second);
+        }
+    }
+
+    //Общая для регионов остановка без объявления была бы одной остановкой для поиска
+    //по имени, но не связывала бы регионы — такие данные не принимаем
+    for (const auto& [name, stop_shards] : stop_shards_) {
+        if (stop_shards.size() < 2) {
+            continue;
+        }
+        const auto boundary_it = boundary_ids_.find(name);
+        for (size_t shard : stop_shards) {
+            const std::vector<size_t>& boundaries = shard_boundaries_[shard];
+            if (boundary_it == boundary_ids_.end()
+                || std::find(boundaries.begin(), boundaries.end(), boundary_it->second) == boundaries.end()) {
+                throw std::invalid_argument("Stop "s + std::string(name) + " is in several regions but is not "s
+                                            "a boundary stop of region "s + std::string(shards[shard].name));
+            }
+        }
+    }
+
+    overlay_edges_.resize(boundary_stops_.size());
+    for (size_t shard = 0; shard < shards.size(); ++shard) {
+        for (size_t from : shard_boundaries_[shard]) {
+            for (size_t to : shard_boundaries_[shard]) {
+                if (from == to) {
+                    continue;
+                }
+                if (std::optional<double> time = routers_[shard].GetRouteTime(boundary_stops_[from], boundary_stops_[to])) {
+                    overlay_edges_[from].push_back({to, shard, *time});
+                }
+            }
+        }
+    }
+}
+
+std::pair<double, std::vector<RouteItem>> ShardedRouter::BuildRoute(std::string_view from, std::string_view to) const {
+    const auto route = FindSegments(from, to);
+    if (!route) {
+        return {-1, {}};
+    }
+    std::vector<RouteItem> items;
+    for (const Segment& segment : route->second) {
+        if (segment.from != segment.to) {
+            std::vector<RouteItem> segment_items = routers_[segment.shard].BuildRoute(segment.from, segment.to).second;
+            items.insert(items.end(), segment_items.begin(), segment_items.end());
+        }
+    }
+    return {route->first, std::move(items)};
+}
+
+std::optional<std::pair<double, std::vector<ShardedRouter::Segment>>> ShardedRouter::FindSegments(std::string_view from, std::string_view to) const {
+    const auto from_it = stop_shards_.find(from);
+    const auto to_it = stop_shards_.find(to);
+    if (from_it == stop_shards_.end() || to_it == stop_shards_.end()) {
+        return std::nullopt;
+    }
+    const std::vector<size_t>& from_shards = from_it->second;
+    const std::vector<size_t>& to_shards = to_it->second;
+
+    //Маршрут, не выходящий из региона
+    double best_time = NO_TIME;
+    size_t direct_shard = 0;
+    for (size_t shard : from_shards) {
+        if (std::find(to_shards.begin(), to_shards.end(), shard) == to_shards.end()) {
+            continue;
+        }
+        if (std::optional<double> time = routers_[shard].GetRouteTime(from, to); time && *time < best_time) {
+            best_time = *time;
+            direct_shard = shard;
+        }
+    }
+
+    //Дейкстра по пограничным остановкам. Начальные расстояния — время от from до границ её регионов
+    struct Previous {
+        size_t shard = 0;
+        std::optional<size_t> boundary; //nullopt — участок начинается в from
+    };
+    std::vector<double> times(boundary_stops_.size(), NO_TIME);
+    std::vector<Previous> previous(boundary_stops_.size());
+    using QueueItem = std::pair<double, size_t>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    for (size_t shard : from_shards) {
+        for (size_t boundary : shard_boundaries_[shard]) {
+            std::optional<double> time = routers_[shard].GetRouteTime(from, boundary_stops_[boundary]);
+            if (time && *time < times[boundary]) {
+                times[boundary] = *time;
+                previous[boundary] = {shard, std::nullopt};
+                queue.emplace(*time, boundary);
+            }
+        }
+    }
+    while (!queue.empty()) {
+        const auto [time, boundary] = queue.top();
+        queue.pop();
+        //Веса неотрицательны: дальше маршрут только длиннее уже найденного
+        if (time >= best_time) {
+            break;
+        }
+        if (time > times[boundary]) {
+            continue;
+        }
+        for (const OverlayEdge& edge : overlay_edges_[boundary]) {
+            if (time + edge.time < times[edge.to]) {
+                times[edge.to] = time + edge.time;
+                previous[edge.to] = {edge.shard, boundary};
+                queue.emplace(times[edge.to], edge.to);
+            }
+        }
+    }
+
+    std::optional<size_t> last_boundary;
+    size_t last_shard = 0;
+    for (size_t shard : to_shards) {
+        for (size_t boundary : shard_boundaries_[shard]) {
+            if (times[boundary] == NO_TIME) {
+                continue;
+            }
+            std::optional<double> time = routers_[shard].GetRouteTime(boundary_stops_[boundary], to);
+            if (time && times[boundary] + *time < best_time) {
+                best_time = times[boundary] + *time;
+                last_boundary = boundary;
+                last_shard = shard;
+            }
+        }
+    }
+
+    if (best_time == NO_TIME) {
+        return std::nullopt;
+    }
+    if (!last_boundary) {
+        return std::pair(best_time, std::vector<Segment>{{direct_shard, from, to}});
+    }
+    std::vector<Segment> segments{{last_shard, boundary_stops_[*last_boundary], to}};
+    for (size_t boundary = *last_boundary;;) {
+        const Previous& prev = previous[boundary];
+        if (!prev.boundary) {
+            segments.push_back({prev.shard, from, boundary_stops_[boundary]});
+            break;
+        }
+        segments.push_back({prev.shard, boundary_stops_[*prev.boundary], boundary_stops_[boundary]});
+        boundary = *prev.boundary;
+    }
+    std::reverse(segments.begin(), segments.end());
+    return std::pair(best_time, std::move(segments));
+}
+
+} // namespace routing
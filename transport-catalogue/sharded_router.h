@@ -0,0 +1,67 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+namespace routing {
+
+// Регион: отдельный справочник и его пограничные остановки — общие с другими регионами.
+// Одноимённые пограничные остановки разных регионов считаются одной остановкой
+struct Shard {
+    std::string_view name;
+    const TransportCatalogue& db;
+    std::vector<std::string_view> boundary_stops;
+};
+
+/*
+ * Маршрутизатор по нескольким регионам. Каждый регион получает собственный TransportRouter,
+ * поэтому память и предрасчёт растут с размером региона, а не всей сети.
+ * Регионы связаны только через пограничные остановки: по таблицам регионов считаются
+ * времена между их пограничными остановками, и из них строится небольшой граф переходов.
+ * Межрегиональный маршрут — путь Дейкстры по этому графу, дополненный участками
+ * от начальной остановки до границы и от границы до конечной.
+ * Маршрут автобуса и пешие пересадки не выходят за пределы региона.
+ */
+class ShardedRouter {
+public:
+    ShardedRouter(const std::vector<Shard>& shards, const RoutingSettings& settings);
+
+    // Как TransportRouter::BuildRoute: время -1, если маршрута нет или остановка неизвестна
+    std::pair<double, std::vector<RouteItem>> BuildRoute(std::string_view from, std::string_view to) const;
+
+private:
+    struct OverlayEdge {
+        size_t to = 0;
+        size_t shard = 0;
+        double time = 0;
+    };
+
+    // Участок маршрута внутри одного региона
+    struct Segment {
+        size_t shard = 0;
+        std::string_view from;
+        std::string_view to;
+    };
+
+    std::deque<TransportRouter> routers_;
+    // Регионы, в которых есть остановка
+    std::unordered_map<std::string_view, std::vector<size_t>> stop_shards_;
+    // Пограничные остановки — вершины графа переходов
+    std::vector<std::string_view> boundary_stops_;
+    std::unordered_map<std::string_view, size_t> boundary_ids_;
+    std::vector<std::vector<size_t>> shard_boundaries_;
+    // Кратчайшие переходы между пограничными остановками внутри регионов
+    std::vector<std::vector<OverlayEdge>> overlay_edges_;
+
+    // Время маршрута и его участки по регионам; nullopt, если маршрута нет
+    std::optional<std::pair<double, std::vector<Segment>>> FindSegments(std::string_view from, std::string_view to) const;
+};
+
+} // namespace routing
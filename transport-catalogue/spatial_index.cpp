@@ -0,0 +1,189 @@
+#define _USE_MATH_DEFINES
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace spatial {
+
+namespace {
+
+// Среднее число остановок в ячейке сетки
+constexpr size_t STOPS_PER_CELL = 2;
+// Минимальный размер ячейки в градусах — на случай, если все остановки на одной широте или долготе
+constexpr double MIN_CELL_DEGREES = 1e-6;
+constexpr double METERS_PER_DEGREE = geo::EARTH_RADIUS * M_PI / 180.0;
+
+bool IsCloser(const StopDistance& lhs, const StopDistance& rhs) {
+    if (lhs.distance != rhs.distance) {
+        return lhs.distance < rhs.distance;
+    }
+    return lhs.stop->name < rhs.stop->name;
+}
+
+} // namespace
+
+StopIndex::StopIndex(std::vector<const Stop*> stops) {
+    if (stops.empty()) {
+        return;
+    }
+
+    bounds_ = {stops.front()->coordinates, stops.front()->coordinates};
+    for (const Stop* stop : stops) {
+        bounds_.min.lat = std::min(bounds_.min.lat, stop->coordinates.lat);
+        bounds_.min.lng = std::min(bounds_.min.lng, stop->coordinates.lng);
+        bounds_.max.lat = std::max(bounds_.max.lat, stop->coordinates.lat);
+        bounds_.max.lng = std::max(bounds_.max.lng, stop->coordinates.lng);
+    }
+
+    const size_t cells_count = std::max<size_t>(1, stops.size() / STOPS_PER_CELL);
+    rows_ = cols_ = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(cells_count))));
+    cell_height_ = std::max((bounds_.max.lat - bounds_.min.lat) / rows_, MIN_CELL_DEGREES);
+    cell_width_ = std::max((bounds_.max.lng - bounds_.min.lng) / cols_, MIN_CELL_DEGREES);
+
+    // Градус долготы короче всего на самой удалённой от экватора широте
+    const double max_abs_lat = std::max(std::abs(bounds_.min.lat), std::abs(bounds_.max.lat));
+    min_cell_extent_ = std::min(cell_height_ * METERS_PER_DEGREE,
+                                cell_width_ * METERS_PER_DEGREE * std::cos(max_abs_lat * M_PI / 180.0));
+
+    //Раскладываем остановки по ячейкам сортировкой подсчётом
+    std::vector<size_t> stop_cells(stops.size());
+    cell_begins_.assign(static_cast<size_t>(rows_) * cols_ + 1, 0);
+    for (size_t i = 0; i < stops.size(); ++i) {
+        const Cell cell = GetCell(stops[i]->coordinates);
+        stop_cells[i] = GetCellId(cell.row, cell.col);
+        ++cell_begins_[stop_cells[i] + 1];
+    }
+    for (size_t i = 1; i < cell_begins_.size(); ++i) {
+        cell_begins_[i] += cell_begins_[i - 1];
+    }
+    stops_.resize(stops.size());
+    std::vector<size_t> positions(cell_begins_.begin(), std::prev(cell_begins_.end()));
+    for (size_t i = 0; i < stops.size(); ++i) {
+        stops_[positions[stop_cells[i]]++] = stops[i];
+    }
+}
+
+std::vector<const Stop*> StopIndex::FindInArea(const Area& area) const {
+    std::vector<const Stop*> result;
+    if (stops_.empty()) {
+        return result;
+    }
+    ForEachStopInCells(GetCell(area.min), GetCell(area.max), [&area, &result](const Stop* stop) {
+        const geo::Coordinates& coords = stop->coordinates;
+        if (coords.lat >= area.min.lat && coords.lat <= area.max.lat
+            && coords.lng >= area.min.lng && coords.lng <= area.max.lng) {
+            result.push_back(stop);
+        }
+    });
+    std::sort(result.begin(), result.end(), [](const Stop* lhs, const Stop* rhs) {
+        return lhs->name < rhs->name;
+    });
+    return result;
+}
+
+std::vector<StopDistance> StopIndex::FindNearest(geo::Coordinates point, size_t count) const {
+    std::vector<StopDistance> candidates;
+    if (stops_.empty() || count == 0) {
+        return candidates;
+    }
+    count = std::min(count, stops_.size());
+
+    const Cell center = GetCell(point);
+    const geo::SpherePoint position = geo::ToSpherePoint(point);
+    auto visit_cell = [this, &position, &candidates](int row, int col) {
+        if (row < 0 || row >= rows_ || col < 0 || col >= cols_) {
+            return;
+        }
+        ForEachStopInCells({row, col}, {row, col}, [&position, &candidates](const Stop* stop) {
+            candidates.push_back({stop, geo::ComputeDistance(position, stop->position)});
+        });
+    };
+
+    //Обходим кольца ячеек вокруг точки, пока следующее кольцо не окажется заведомо
+    //дальше count-й найденной остановки
+    const int max_ring = std::max(rows_, cols_);
+    for (int ring = 0; ring <= max_ring; ++ring) {
+        if (candidates.size() >= count) {
+            std::nth_element(candidates.begin(), candidates.begin() + (count - 1), candidates.end(), IsCloser);
+            if ((ring - 1) * min_cell_extent_ > candidates[count - 1].distance) {
+                break;
+            }
+        }
+        for (int col = center.col - ring; col <= center.col + ring; ++col) {
+            visit_cell(center.row - ring, col);
+            if (ring > 0) {
+                visit_cell(center.row + ring, col);
+            }
+        }
+        for (int row = center.row - ring + 1; row < center.row + ring; ++row) {
+            visit_cell(row, center.col - ring);
+            visit_cell(row, center.col + ring);
+        }
+    }
+
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), IsCloser);
+    candidates.resize(count);
+    return candidates;
+}
+
+std::vector<StopDistance> StopIndex::FindWithinRadius(geo::Coordinates point, double radius) const {
+    std::vector<StopDistance> result;
+    if (stops_.empty() || radius < 0) {
+        return result;
+    }
+
+    const double lat_delta = radius / METERS_PER_DEGREE;
+    const double max_abs_lat = std::min(90.0, std::abs(point.lat) + lat_delta);
+    const double lng_scale = std::cos(max_abs_lat * M_PI / 180.0);
+    // У полюса окрестность охватывает все долготы
+    const double lng_delta = lng_scale > lat_delta / 180.0 ? lat_delta / lng_scale : 360.0;
+
+    const Cell from = GetCell({point.lat - lat_delta, point.lng - lng_delta});
+    const Cell to = GetCell({point.lat + lat_delta, point.lng + lng_delta});
+    const geo::SpherePoint position = geo::ToSpherePoint(point);
+    ForEachStopInCells(from, to, [&position, radius, &result](const Stop* stop) {
+        const double distance = geo::ComputeDistance(position, stop->position);
+        if (distance <= radius) {
+            result.push_back({stop, distance});
+        }
+    });
+    std::sort(result.begin(), result.end(), IsCloser);
+    return result;
+}
+
+size_t StopIndex::GetStopsCount() const {
+    return stops_.size();
+}
+
+memory::Usage StopIndex::GetMemoryUsage() const {
+    return {memory::GetHeapBytes(stops_) + memory::GetHeapBytes(cell_begins_), stops_.size()};
+}
+
+StopIndex::Cell StopIndex::GetCell(geo::Coordinates point) const {
+    auto to_index = [](double offset, double cell_size, int cells) {
+        const double index = std::floor(offset / cell_size);
+        return static_cast<int>(std::clamp(index, 0.0, static_cast<double>(cells - 1)));
+    };
+    return {
+        to_index(point.lat - bounds_.min.lat, cell_height_, rows_),
+        to_index(point.lng - bounds_.min.lng, cell_width_, cols_)
+    };
+}
+
+size_t StopIndex::GetCellId(int row, int col) const {
+    return static_cast<size_t>(row) * cols_ + col;
+}
+
+template <typename Func>
+void StopIndex::ForEachStopInCells(Cell from, Cell to, Func func) const {
+    for (int row = from.row; row <= to.row; ++row) {
+        const auto begin = stops_.begin() + cell_begins_[GetCellId(row, from.col)];
+        const auto end = stops_.begin() + cell_begins_[GetCellId(row, to.col) + 1];
+        for (auto it = begin; it != end; ++it) {
+            func(*it);
+        }
+    }
+}
+
+} // namespace spatial
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "domain.h"
+#include "geo.h"
+#include "memory_usage.h"
+
+namespace spatial {
+
+// Прямоугольная область в координатах широты и долготы
+struct Area {
+    geo::Coordinates min;
+    geo::Coordinates max;
+};
+
+struct StopDistance {
+    const Stop* stop = nullptr;
+    double distance = 0;
+};
+
+/*
+ * Статический пространственный индекс остановок — равномерная сетка по широте и долготе.
+ * Строится один раз по всем остановкам, ячейки хранятся упакованно: остановки
+ * отсортированы по номеру ячейки, а для каждой ячейки известно начало её диапазона.
+ * Размер ячейки подбирается так, чтобы в ней было в среднем несколько остановок,
+ * поэтому запросы затрагивают только ближайшие ячейки, а не все остановки.
+ * Рассчитан на области размером с город или регион (без перехода через 180-й меридиан).
+ */
+class StopIndex {
+public:
+    StopIndex() = default;
+    explicit StopIndex(std::vector<const Stop*> stops);
+
+    // Остановки внутри области (границы включаются), отсортированные по имени
+    std::vector<const Stop*> FindInArea(const Area& area) const;
+    // Не более count ближайших к точке остановок в порядке возрастания расстояния
+    std::vector<StopDistance> FindNearest(geo::Coordinates point, size_t count) const;
+    // Остановки не дальше radius метров от точки в порядке возрастания расстояния
+    std::vector<StopDistance> FindWithinRadius(geo::Coordinates point, double radius) const;
+
+    size_t GetStopsCount() const;
+    memory::Usage GetMemoryUsage() const;
+
+private:
+    struct Cell {
+        int row = 0;
+        int col = 0;
+    };
+
+    Area bounds_{};
+    double cell_height_ = 1;
+    double cell_width_ = 1;
+    int rows_ = 0;
+    int cols_ = 0;
+    // Минимальный размер ячейки в метрах — для отсечения дальних ячеек при поиске
+    double min_cell_extent_ = 0;
+    std::vector<const Stop*> stops_;
+    std::vector<size_t> cell_begins_;
+
+    Cell GetCell(geo::Coordinates point) const;
+    size_t GetCellId(int row, int col) const;
+    template <typename Func>
+    void ForEachStopInCells(Cell from, Cell to, Func func) const;
+};
+
+} // namespace spatial
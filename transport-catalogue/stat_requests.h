@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string_view>
+#include <variant>
+
+#include "geo.h"
+#include "spatial_index.h"
+
+namespace requests {
+
+/*
+ * Запросы stat_requests, разобранные один раз: поля уже проверены и приведены к своим типам,
+ * значения по умолчанию подставлены. Строки ссылаются на разобранный документ
+ * и действительны, пока он жив
+ */
+
+struct BusRequest {
+    int id = 0;
+    std::string_view name;
+};
+
+struct StopRequest {
+    int id = 0;
+    std::string_view name;
+};
+
+//Автобусы, идущие от from до to без пересадок
+struct DirectBusesRequest {
+    int id = 0;
+    std::string_view from;
+    std::string_view to;
+};
+
+struct RouteRequest {
+    int id = 0;
+    std::string_view from;
+    std::string_view to;
+};
+
+struct MapRequest {
+    int id = 0;
+};
+
+struct NearestStopsRequest {
+    int id = 0;
+    geo::Coordinates point;
+    int count = 1;
+};
+
+struct StopsInAreaRequest {
+    int id = 0;
+    spatial::Area area;
+};
+
+struct StopSearchRequest {
+    int id = 0;
+    std::string_view query;
+    int count = 10;
+    int max_errors = 0;
+};
+
+struct StatsRequest {
+    int id = 0;
+};
+
+using StatRequest = std::variant<BusRequest, StopRequest, DirectBusesRequest, RouteRequest, MapRequest,
+                                 NearestStopsRequest, StopsInAreaRequest, StopSearchRequest, StatsRequest>;
+
+} //namespace requests
@@ -0,0 +1,219 @@
+#include "stop_search.h"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+namespace search {
+
+namespace {
+
+constexpr char32_t REPLACEMENT_CHAR = 0xFFFD;
+
+char32_t FoldCase(char32_t c) {
+    if (c >= U'A' && c <= U'Z') {
+        return c + (U'a' - U'A');
+    }
+    if (c >= U'А' && c <= U'Я') {
+        return c + (U'а' - U'А');
+    }
+    if (c >= U'Ѐ' && c <= U'Џ') {
+        c += U'ѐ' - U'Ѐ';
+    }
+    // В названиях «ё» часто пишут как «е»
+    return c == U'ё' ? U'е' : c;
+}
+
+// Декодирует UTF-8 и приводит к нижнему регистру. Некорректные байты заменяются на U+FFFD
+std::u32string Normalize(std::string_view str) {
+    std::u32string result;
+    result.reserve(str.size());
+    size_t pos = 0;
+    while (pos < str.size()) {
+        const auto lead = static_cast<unsigned char>(str[pos]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        char32_t c = length == 1 ? lead : length == 2 ? lead & 0x1F : length == 3 ? lead & 0x0F : lead & 0x07;
+        for (size_t i = 1; i < length; ++i) {
+            const auto next = pos + i < str.size() ? static_cast<unsigned char>(str[pos + i]) : 0;
+            if ((next >> 6) != 0x2) {
+                length = 0;
+                break;
+            }
+            c = (c << 6) | (next & 0x3F);
+        }
+        if (length == 0) {
+            c = REPLACEMENT_CHAR;
+            length = 1;
+        }
+        result.push_back(FoldCase(c));
+        pos += length;
+    }
+    return result;
+}
+
+} // namespace
+
+StopSearch::StopSearch(const std::vector<const Stop*>& stops) {
+    std::vector<std::u32string> keys;
+    keys.reserve(stops.size());
+    for (const Stop* stop : stops) {
+        keys.push_back(Normalize(stop->name));
+    }
+    std::vector<uint32_t> order(stops.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&keys, &stops](uint32_t lhs, uint32_t rhs) {
+        return std::tie(keys[lhs], stops[lhs]->name) < std::tie(keys[rhs], stops[rhs]->name);
+    });
+
+    size_t keys_size = 0;
+    for (const std::u32string& key : keys) {
+        keys_size += key.size();
+    }
+    keys_.reserve(keys_size);
+    entries_.reserve(stops.size());
+    for (uint32_t i : order) {
+        entries_.push_back({static_cast<uint32_t>(keys_.size()), static_cast<uint32_t>(keys[i].size()), stops[i]});
+        keys_ += keys[i];
+    }
+
+}
+
+void StopSearch::Add(std::span<const Stop* const> stops) {
+    const size_t old_size = entries_.size();
+    for (const Stop* stop : stops) {
+        const std::u32string key = Normalize(stop->name);
+        entries_.push_back({static_cast<uint32_t>(keys_.size()), static_cast<uint32_t>(key.size()), stop});
+        keys_ += key;
+    }
+    //Порядок тот же, что и в конструкторе; расположение ключей в буфере на него не влияет
+    const auto is_less = [this](const Entry& lhs, const Entry& rhs) {
+        return std::pair(GetKey(lhs), lhs.stop->name) < std::pair(GetKey(rhs), rhs.stop->name);
+    };
+    const auto middle = entries_.begin() + static_cast<std::ptrdiff_t>(old_size);
+    std::sort(middle, entries_.end(), is_less);
+    std::inplace_merge(entries_.begin(), middle, entries_.end(), is_less);
+}
+
+std::vector<const Stop*> StopSearch::FindByPrefix(std::string_view prefix, size_t count) const {
+    const auto [begin, end] = FindPrefixRange(Normalize(prefix));
+    std::vector<const Stop*> result;
+    for (size_t i = begin; i < std::min(end, begin + count); ++i) {
+        result.push_back(entries_[i].stop);
+    }
+    return result;
+}
+
+std::vector<StopMatch> StopSearch::Find(std::string_view query, size_t count, int max_errors) const {
+    const std::u32string key = Normalize(query);
+    const auto [prefix_begin, prefix_end] = FindPrefixRange(key);
+    std::vector<MatchRange> matches{{0, prefix_begin, prefix_end}};
+    if (prefix_end - prefix_begin >= count) {
+        max_errors = 0;
+    }
+    //Совпадения с меньшим числом ошибок идут первыми, поэтому увеличиваем допустимое
+    //число ошибок, только пока не набрано count результатов: окрестность запроса
+    //растёт с каждой ошибкой во много раз
+    std::vector<int> rows;
+    for (int errors = 1; errors <= max_errors; ++errors) {
+        //Глубже key.size() + errors символов ошибок заведомо больше допустимого
+        rows.assign((key.size() + 1) * (key.size() + errors + 1), 0);
+        std::iota(rows.begin(), rows.begin() + key.size() + 1, 0);
+        matches.clear();
+        CollectMatches(key, errors, 0, 0, entries_.size(), static_cast<int>(key.size()), rows, matches);
+        //Диапазоны не пересекаются, поэтому при равном числе ошибок порядок алфавитный
+        std::sort(matches.begin(), matches.end(), [](const MatchRange& lhs, const MatchRange& rhs) {
+            return std::pair(lhs.errors, lhs.begin) < std::pair(rhs.errors, rhs.begin);
+        });
+        size_t found = 0;
+        for (const MatchRange& range : matches) {
+            found += range.end - range.begin;
+        }
+        if (found >= count) {
+            break;
+        }
+    }
+
+    std::vector<StopMatch> result;
+    for (const MatchRange& range : matches) {
+        for (size_t i = range.begin; i < range.end && result.size() < count; ++i) {
+            result.push_back({entries_[i].stop, range.errors});
+        }
+    }
+    return result;
+}
+
+int StopSearch::GetDefaultMaxErrors(std::string_view query) {
+    const size_t length = Normalize(query).size();
+    return length < 4 ? 0 : length < 8 ? 1 : 2;
+}
+
+memory::Usage StopSearch::GetMemoryUsage() const {
+    return {memory::GetHeapBytes(keys_) + memory::GetHeapBytes(entries_), entries_.size()};
+}
+
+std::u32string_view StopSearch::GetKey(const Entry& entry) const {
+    return std::u32string_view(keys_).substr(entry.key_begin, entry.key_size);
+}
+
+std::pair<size_t, size_t> StopSearch::FindPrefixRange(std::u32string_view prefix) const {
+    const auto begin = std::partition_point(entries_.begin(), entries_.end(), [this, prefix](const Entry& entry) {
+        return GetKey(entry) < prefix;
+    });
+    const auto end = std::partition_point(begin, entries_.end(), [this, prefix](const Entry& entry) {
+        return GetKey(entry).starts_with(prefix);
+    });
+    return {static_cast<size_t>(begin - entries_.begin()), static_cast<size_t>(end - entries_.begin())};
+}
+
+void StopSearch::CollectMatches(std::u32string_view query, int max_errors, size_t depth, size_t begin, size_t end,
+                                int best_errors, std::vector<int>& rows, std::vector<MatchRange>& matches) const {
+    //rows[depth * width + i] — расстояние между первыми i символами запроса и общим началом узла.
+    //best_errors — наименьшее расстояние от всего запроса до начала этого общего начала
+    const size_t width = query.size() + 1;
+    const int* row = rows.data() + depth * width;
+    const int row_min = *std::min_element(row, row + width);
+    //Ниже расстояние не уменьшится: все записи узла получают лучшее найденное число ошибок
+    if (row_min > max_errors || row_min >= best_errors) {
+        if (best_errors <= max_errors) {
+            matches.push_back({best_errors, begin, end});
+        }
+        return;
+    }
+
+    //Ключи, которые здесь заканчиваются, при сортировке стоят первыми
+    const size_t children_begin = std::partition_point(entries_.begin() + begin, entries_.begin() + end,
+        [depth](const Entry& entry) {
+            return entry.key_size == depth;
+        }) - entries_.begin();
+    if (children_begin > begin && best_errors <= max_errors) {
+        matches.push_back({best_errors, begin, children_begin});
+    }
+
+    int* child_row = rows.data() + (depth + 1) * width;
+    for (size_t child_begin = children_begin; child_begin < end;) {
+        const char32_t c = GetKey(entries_[child_begin])[depth];
+        //Дети обычно малы, поэтому конец диапазона ищем с шагом, удваивающимся от его начала
+        size_t step = 1;
+        size_t child_last = child_begin;
+        while (child_last + step < end && GetKey(entries_[child_last + step])[depth] == c) {
+            child_last += step;
+            step *= 2;
+        }
+        const size_t child_end = std::partition_point(entries_.begin() + child_last + 1,
+            entries_.begin() + std::min(end, child_last + step),
+            [this, depth, c](const Entry& entry) {
+                return GetKey(entry)[depth] == c;
+            }) - entries_.begin();
+        child_row[0] = row[0] + 1;
+        for (size_t i = 1; i < width; ++i) {
+            const int replace = row[i - 1] + (query[i - 1] == c ? 0 : 1);
+            child_row[i] = std::min({replace, row[i] + 1, child_row[i - 1] + 1});
+        }
+        CollectMatches(query, max_errors, depth + 1, child_begin, child_end,
+                       std::min(best_errors, child_row[width - 1]), rows, matches);
+        child_begin = child_end;
+    }
+}
+
+} // namespace search
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "domain.h"
+#include "memory_usage.h"
+
+namespace search {
+
+struct StopMatch {
+    const Stop* stop = nullptr;
+    // Число исправлений (вставок, удалений, замен символов), после которых
+    // запрос становится началом имени остановки. 0 — точное совпадение начала
+    int errors = 0;
+};
+
+/*
+ * Статический индекс имён остановок для автодополнения.
+ * Имена приводятся к нижнему регистру (латиница и кириллица) и хранятся в одном буфере
+ * в кодировке UTF-32, отсортированными. Отсортированный массив служит неявным префиксным
+ * деревом: узел — диапазон имён с общим началом, дети — поддиапазоны по следующему символу.
+ * Поиск по началу имени — двоичный поиск диапазона. Поиск с опечатками обходит дерево,
+ * считая строки таблицы расстояния Левенштейна, и отсекает ветви, где ошибок уже больше
+ * допустимого, так что просматривает только окрестность запроса, а не все остановки.
+ */
+class StopSearch {
+public:
+    StopSearch() = default;
+    explicit StopSearch(const std::vector<const Stop*>& stops);
+
+    // Добавляет остановки, не пересчитывая ключи уже добавленных: новые записи
+    // сортируются отдельно и сливаются с имеющимися
+    void Add(std::span<const Stop* const> stops);
+
+    // Не более count остановок, имя которых начинается с prefix (без учёта регистра), по алфавиту
+    std::vector<const Stop*> FindByPrefix(std::string_view prefix, size_t count) const;
+    // Не более count остановок, начало имени которых отличается от query не более чем
+    // на max_errors символов. Сначала меньшее число ошибок, при равенстве — по алфавиту
+    std::vector<StopMatch> Find(std::string_view query, size_t count, int max_errors) const;
+
+    memory::Usage GetMemoryUsage() const;
+
+    // Допустимое число опечаток по умолчанию — в зависимости от длины запроса
+    static int GetDefaultMaxErrors(std::string_view query);
+
+private:
+    struct Entry {
+        uint32_t key_begin = 0;
+        uint32_t key_size = 0;
+        const Stop* stop = nullptr;
+    };
+
+    // Диапазон записей entries_ с одинаковым числом ошибок
+    struct MatchRange {
+        int errors = 0;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::u32string keys_;
+    // Отсортированы по ключу
+    std::vector<Entry> entries_;
+
+    std::u32string_view GetKey(const Entry& entry) const;
+    // Диапазон записей entries_, ключи которых начинаются с prefix
+    std::pair<size_t, size_t> FindPrefixRange(std::u32string_view prefix) const;
+    // Обходит узел неявного дерева: записи [begin, end) с общим началом длины depth.
+    // rows — строки таблицы расстояний для всех глубин, строка узла уже посчитана
+    void CollectMatches(std::u32string_view query, int max_errors, size_t depth, size_t begin, size_t end,
+                        int best_errors, std::vector<int>& rows, std::vector<MatchRange>& matches) const;
+};
+
+} // namespace search
@@ -122,6 +122,10 @@ Circle& Circle::SetRadius(double radius)  {
     return *this;
 }
 
+size_t Circle::GetHeapBytes() const {
+    return sizeof(Circle);
+}
+
 void Circle::RenderObject(const RenderContext& context) const {
     auto& out = context.out;
     out << "<circle cx=\""sv << center_.x << "\" cy=\""sv << center_.y << "\" "sv;
@@ -137,6 +141,10 @@ Polyline& Polyline::AddPoint(Point point){
     return *this;
 }
 
+size_t Polyline::GetHeapBytes() const {
+    return sizeof(Polyline) + memory::GetHeapBytes(points_);
+}
+
 void Polyline::RenderObject(const RenderContext& context) const {
     auto& out = context.out;
     out << "<polyline points=\""sv;
@@ -193,6 +201,15 @@ Text& Text::SetData(std::string data){
     data_ = std::move(result);
     return *this;
 }
+
+size_t Text::GetHeapBytes() const {
+    size_t bytes = sizeof(Text) + memory::GetHeapBytes(font_family_) + memory::GetHeapBytes(font_weight_)
+        + memory::GetHeapBytes(data_) + memory::GetHeapBytes(map_);
+    for (const auto& [c, escaped] : map_) {
+        bytes += memory::GetHeapBytes(escaped);
+    }
+    return bytes;
+}
 // Прочие данные и методы, необходимые для реализации элемента <text>
 
 void Text::RenderObject(const RenderContext& context) const{
@@ -218,6 +235,14 @@ void Document::AddPtr(std::unique_ptr<Object>&& obj){
     objects_.emplace_back(std::move(obj));
 }
 
+memory::Usage Document::GetMemoryUsage() const {
+    memory::Usage usage{memory::GetHeapBytes(objects_), objects_.size()};
+    for (const auto& obj : objects_) {
+        usage.bytes += obj->GetHeapBytes();
+    }
+    return usage;
+}
+
 void Document::Render(std::ostream& out) const {
     out << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"sv;
     out << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">\n"sv;
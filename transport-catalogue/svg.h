@@ -9,6 +9,8 @@
 #include <vector>
 #include <unordered_map>
 
+#include "memory_usage.h"
+
 namespace svg {
 
 using namespace std::literals;
@@ -104,6 +106,8 @@ struct RenderContext {
 class Object {
 public:
     void Render(const RenderContext& context) const;
+    // Память объекта в куче вместе с его данными
+    virtual size_t GetHeapBytes() const = 0;
 
     virtual ~Object() = default;
 
@@ -210,6 +214,7 @@ class Circle final : public Object, public PathProps<Circle>{
 public:
     Circle& SetCenter(Point center);
     Circle& SetRadius(double radius);
+    size_t GetHeapBytes() const override;
 
 private:
     void RenderObject(const RenderContext& context) const override;
@@ -226,6 +231,7 @@ class Polyline final : public Object, public PathProps<Polyline> {
 public:
     // Добавляет очередную вершину к ломаной линии
     Polyline& AddPoint(Point point);
+    size_t GetHeapBytes() const override;
 
 private:
     void RenderObject(const RenderContext& context) const override;
@@ -258,6 +264,8 @@ public:
     // Задаёт текстовое содержимое объекта (отображается внутри тега text)
     Text& SetData(std::string data);
 
+    size_t GetHeapBytes() const override;
+
     // Прочие данные и методы, необходимые для реализации элемента <text>
 private:
     void RenderObject(const RenderContext& context) const override;
@@ -283,6 +291,8 @@ public:
     void AddPtr(std::unique_ptr<Object>&& obj) override;
 
     void Render(std::ostream& out) const;
+    // Элементы — объекты документа
+    memory::Usage GetMemoryUsage() const;
 private:
     std::vector<std::unique_ptr<Object>> objects_;
 };
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+struct Point {
+    double x;
+    double y;
+};
+
+} // namespace
+
+TEST(ArenaKeepsAddressesAcrossBlocks) {
+    memory::Arena arena(64);
+    std::vector<std::string_view> names;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 100; ++i) {
+        expected.push_back("stop "s + std::to_string(i));
+        names.push_back(arena.CopyString(expected.back()));
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+        ASSERT_EQUAL(names[i], expected[i]);
+    }
+    ASSERT(arena.GetMemoryUsage().items > 1);
+}
+
+TEST(ArenaAlignsObjects) {
+    memory::Arena arena(256);
+    arena.CopyString("x"sv);
+    const Point* point = arena.Create<Point>(Point{1, 2});
+    ASSERT_EQUAL(reinterpret_cast<std::uintptr_t>(point) % alignof(Point), 0u);
+    ASSERT_EQUAL(point->y, 2.0);
+}
+
+TEST(ArenaGivesLargeRequestsTheirOwnBlock) {
+    memory::Arena arena(16);
+    const std::string big(1000, 'a');
+    ASSERT_EQUAL(arena.CopyString(big), big);
+}
+
+TEST(ArenaCopyRangeIsContiguous) {
+    memory::Arena arena;
+    const std::vector<int> values = {1, 2, 3, 4};
+    const std::span<const int> copy = arena.CopyRange(values.begin(), values.end());
+    ASSERT(std::equal(copy.begin(), copy.end(), values.begin(), values.end()));
+    ASSERT(arena.CopyRange(values.end(), values.end()).empty());
+}
+
+TEST(ArenaMoveConstructionTransfersBlocksAndResetsSource) {
+    memory::Arena source(64);
+    const std::string_view name = source.CopyString("Tverskaya"sv);
+    memory::Arena target(std::move(source));
+    ASSERT_EQUAL(name, "Tverskaya"sv);
+    ASSERT_EQUAL(target.GetMemoryUsage().items, 1u);
+    ASSERT_EQUAL(source.GetMemoryUsage().items, 0u);
+    //Исходная арена не пишет в блок, которым теперь владеет target
+    ASSERT_EQUAL(source.CopyString("Arbat"sv), "Arbat"sv);
+    ASSERT_EQUAL(target.CopyString("Sretenka"sv), "Sretenka"sv);
+    ASSERT_EQUAL(name, "Tverskaya"sv);
+    ASSERT_EQUAL(source.GetMemoryUsage().items, 1u);
+}
+
+TEST(ArenaMoveAssignmentTransfersBlocksAndResetsSource) {
+    memory::Arena source(64);
+    const std::string_view name = source.CopyString("Tverskaya"sv);
+    memory::Arena target(64);
+    target.CopyString("old"sv);
+    target = std::move(source);
+    ASSERT_EQUAL(name, "Tverskaya"sv);
+    ASSERT_EQUAL(target.GetMemoryUsage().items, 1u);
+    ASSERT_EQUAL(source.GetMemoryUsage().items, 0u);
+    ASSERT_EQUAL(source.CopyString("Arbat"sv), "Arbat"sv);
+    ASSERT_EQUAL(name, "Tverskaya"sv);
+}
@@ -0,0 +1,112 @@
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Маршруты через остановку перебором всех маршрутов, в порядке имён
+std::vector<std::string_view> FindBusesOnStop(const TransportCatalogue& db, std::string_view stop) {
+    std::vector<std::string_view> result;
+    for (const auto& [name, bus] : db.GetBuses()) {
+        for (std::string_view bus_stop : bus->stops) {
+            if (bus_stop == stop) {
+                result.push_back(name);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+//Маршруты, где from встречается раньше to, перебором всех пар позиций
+std::vector<std::string_view> FindDirectBuses(const TransportCatalogue& db, std::string_view from, std::string_view to) {
+    std::vector<std::string_view> result;
+    for (const auto& [name, bus] : db.GetBuses()) {
+        bool found = false;
+        for (size_t i = 0; i < bus->stops.size() && !found; ++i) {
+            for (size_t j = i + 1; j < bus->stops.size() && !found; ++j) {
+                found = bus->stops[i] == from && bus->stops[j] == to;
+            }
+        }
+        if (found) {
+            result.push_back(name);
+        }
+    }
+    return result;
+}
+
+void AssertSameAsBruteForce(const TransportCatalogue& db) {
+    for (const Stop* from : db.GetStopsList()) {
+        ASSERT_EQUAL(db.GetBusesOnStop(from->name), std::optional(FindBusesOnStop(db, from->name)));
+        for (const Stop* to : db.GetStopsList()) {
+            ASSERT_EQUAL(db.GetDirectBuses(from->name, to->name), std::optional(FindDirectBuses(db, from->name, to->name)));
+        }
+    }
+}
+
+} // namespace
+
+TEST(DirectBusesMatchBruteForce) {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        //Мало остановок на много маршрутов: у пар остановок много общих маршрутов
+        const TestNetwork network = MakeRandomNetwork(seed, 30, 40, 8);
+        TransportCatalogue db;
+        db.Load(network.data);
+        AssertSameAsBruteForce(db);
+    }
+}
+
+TEST(DirectBusesFollowUpdates) {
+    const TestNetwork base = MakeRandomNetwork(4, 30, 10, 6);
+    TransportCatalogue db;
+    db.Load(base.data);
+    TestNetwork delta;
+    const std::string_view added = delta.AddStop("Added", {55.75, 37.60});
+    const std::string_view lonely = delta.AddStop("Lonely", {55.76, 37.61});
+    delta.AddDistance(added, base.data.stops[0].name, 500);
+    delta.AddBus("Added bus", {added, base.data.stops[0].name, base.data.stops[1].name}, true);
+    //Новое расстояние на старом маршруте заменяет его запись
+    delta.AddDistance(base.data.distances[0].from, base.data.distances[0].to, 12345);
+    ASSERT(!db.Update(delta.data).changed_buses.empty());
+    AssertSameAsBruteForce(db);
+    ASSERT_EQUAL(db.GetBusesOnStop(lonely), std::optional(std::vector<std::string_view>{}));
+    ASSERT_EQUAL(db.GetDirectBuses(lonely, added), std::optional(std::vector<std::string_view>{}));
+}
+
+TEST(DirectBusesRespectDirection) {
+    TestNetwork network;
+    const std::string_view a = network.AddStop("A", {55.70, 37.60});
+    const std::string_view b = network.AddStop("B", {55.71, 37.60});
+    const std::string_view c = network.AddStop("C", {55.72, 37.60});
+    const std::string_view d = network.AddStop("D", {55.73, 37.60});
+    network.AddDistance(a, b, 1000);
+    network.AddDistance(b, c, 1000);
+    network.AddDistance(c, a, 1000);
+    network.AddDistance(c, d, 1000);
+    //Кольцо A→B→C→A и линейный маршрут C↔D
+    network.AddBus("ring", {a, b, c, a}, true);
+    network.AddBus("line", {c, d}, false);
+    TransportCatalogue db;
+    db.Load(network.data);
+
+    using Names = std::vector<std::string_view>;
+    ASSERT_EQUAL(db.GetDirectBuses(a, c), std::optional(Names{"ring"sv}));
+    //Кольцо возвращается в начало, поэтому и в обратную сторону без пересадки
+    ASSERT_EQUAL(db.GetDirectBuses(c, a), std::optional(Names{"ring"sv}));
+    ASSERT_EQUAL(db.GetDirectBuses(c, b), std::optional(Names{}));
+    ASSERT_EQUAL(db.GetDirectBuses(d, c), std::optional(Names{"line"sv}));
+    //От остановки до неё же — только если маршрут проходит её дважды
+    ASSERT_EQUAL(db.GetDirectBuses(a, a), std::optional(Names{"ring"sv}));
+    ASSERT_EQUAL(db.GetDirectBuses(b, b), std::optional(Names{}));
+    ASSERT_EQUAL(db.GetDirectBuses(c, c), std::optional(Names{"line"sv}));
+    ASSERT_EQUAL(db.GetBusesOnStop(c), std::optional(Names{"line"sv, "ring"sv}));
+    ASSERT(!db.GetDirectBuses("Unknown"sv, a));
+    ASSERT(!db.GetDirectBuses(a, "Unknown"sv));
+    ASSERT(!db.GetBusesOnStop("Unknown"sv));
+}
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+using namespace std::literals;
+
+namespace {
+
+TransportCatalogue LoadSequentially(const CatalogueData& data) {
+    TransportCatalogue db;
+    for (const Stop& stop : data.stops) {
+        db.AddStop(stop);
+    }
+    for (const Distance& distance : data.distances) {
+        db.AddDistance(distance.from, {{distance.to, distance.distance}});
+    }
+    for (const Bus& bus : data.buses) {
+        db.AddBus(bus);
+    }
+    db.BuildIndexes();
+    return db;
+}
+
+} // namespace
+
+TEST(CatalogueLoadMatchesSequentialAdds) {
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        const TestNetwork network = MakeRandomNetwork(seed, 300, 80, 12);
+        TransportCatalogue loaded;
+        loaded.Load(network.data);
+        AssertSameCatalogue(loaded, LoadSequentially(network.data));
+    }
+}
+
+TEST(CatalogueLoadComputesBusInfo) {
+    const geo::Coordinates a_coordinates{55.60, 37.60};
+    const geo::Coordinates b_coordinates{55.61, 37.60};
+    const geo::Coordinates c_coordinates{55.62, 37.60};
+    TestNetwork network;
+    const std::string_view a = network.AddStop("A", a_coordinates);
+    const std::string_view b = network.AddStop("B", b_coordinates);
+    const std::string_view c = network.AddStop("C", c_coordinates);
+    network.AddDistance(a, b, 1200);
+    network.AddDistance(b, a, 1300);
+    network.AddDistance(b, c, 1500);
+    network.AddBus("1", {a, b, c}, false);
+    network.AddBus("2", {a, c, a}, true);
+    TransportCatalogue db;
+    db.Load(network.data);
+
+    const BusInfo line = db.GetBusInfo("1"sv);
+    ASSERT_EQUAL(line.stops_on_route, 5u);
+    ASSERT_EQUAL(line.unique_stops, 3u);
+    //C→B не задано и берётся из B→C
+    ASSERT_EQUAL(line.route_length, 1200 + 1500 + 1500 + 1300);
+    const double straight = 2 * (geo::ComputeDistance(a_coordinates, b_coordinates) + geo::ComputeDistance(b_coordinates, c_coordinates));
+    ASSERT(std::abs(line.curvature - line.route_length / straight) < 1e-9);
+
+    const BusInfo circle = db.GetBusInfo("2"sv);
+    ASSERT_EQUAL(circle.stops_on_route, 3u);
+    ASSERT_EQUAL(circle.unique_stops, 2u);
+    //Между A и C расстояние не задано ни в одну сторону
+    ASSERT_EQUAL(circle.route_length, 0);
+
+    ASSERT_EQUAL(db.GetBusesOnStop("A"sv), std::optional(std::vector{"1"sv, "2"sv}));
+    ASSERT_EQUAL(db.GetBusesOnStop("B"sv), std::optional(std::vector{"1"sv}));
+    ASSERT(!db.GetBusesOnStop("D"sv));
+    ASSERT_EQUAL(db.GetBusInfo("3"sv).stops_on_route, 0u);
+}
+
+TEST(CatalogueLoadCopiesNames) {
+    TransportCatalogue db;
+    {
+        const TestNetwork network = MakeRandomNetwork(7, 20, 5, 4);
+        db.Load(network.data);
+    }
+    const Stop* stop = db.FindStop("Stop 3"sv);
+    ASSERT(stop != nullptr);
+    ASSERT_EQUAL(stop->name, "Stop 3"sv);
+    ASSERT_EQUAL(db.GetBusInfo("Bus 0"sv).stops_on_route, 5u);
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "reference_router.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Пакет изменений к сети base: новые остановки с расстояниями до старых, новые маршруты
+//через старые и новые остановки и changed_count новых расстояний между старыми остановками
+TestNetwork MakeRandomDelta(const TestNetwork& base, unsigned seed, size_t stops_count, size_t buses_count, size_t changed_count) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> lat(55.60, 55.90);
+    std::uniform_real_distribution<double> lng(37.40, 37.80);
+    std::uniform_int_distribution<int> distance(100, 5000);
+    TestNetwork delta;
+    std::vector<std::string_view> stops;
+    for (const Stop& stop : base.data.stops) {
+        stops.push_back(stop.name);
+    }
+    const size_t old_stops_count = stops.size();
+    for (size_t i = 0; i < stops_count; ++i) {
+        const std::string_view added = delta.AddStop("Added " + std::to_string(seed) + "/" + std::to_string(i), {lat(generator), lng(generator)});
+        delta.AddDistance(added, stops[generator() % old_stops_count], distance(generator));
+        stops.push_back(added);
+    }
+    for (size_t i = 0; i < changed_count; ++i) {
+        delta.AddDistance(stops[generator() % old_stops_count], stops[generator() % old_stops_count], distance(generator));
+    }
+    for (size_t i = 0; i < buses_count; ++i) {
+        std::vector<std::string_view> route;
+        for (size_t j = 0; j < 5; ++j) {
+            route.push_back(stops[generator() % stops.size()]);
+        }
+        for (size_t j = 1; j < route.size(); ++j) {
+            delta.AddDistance(route[j - 1], route[j], distance(generator));
+        }
+        delta.AddBus("Added bus " + std::to_string(seed) + "/" + std::to_string(i), route, false);
+    }
+    return delta;
+}
+
+//Данные base и delta одним пакетом, как если бы всё было во входном документе сразу
+CatalogueData Merge(const CatalogueData& base, const CatalogueData& delta) {
+    CatalogueData result = base;
+    result.stops.insert(result.stops.end(), delta.stops.begin(), delta.stops.end());
+    result.distances.insert(result.distances.end(), delta.distances.begin(), delta.distances.end());
+    result.buses.insert(result.buses.end(), delta.buses.begin(), delta.buses.end());
+    return result;
+}
+
+std::vector<std::string_view> GetNames(const std::vector<const Stop*>& stops) {
+    std::vector<std::string_view> names;
+    for (const Stop* stop : stops) {
+        names.push_back(stop->name);
+    }
+    return names;
+}
+
+//Кроме записей совпадают и индексы, которые Update перестраивает выборочно
+void AssertSameIndexes(const TransportCatalogue& actual, const TransportCatalogue& expected) {
+    const auto& stops = expected.GetStopsList();
+    for (size_t i = 0; i < stops.size(); ++i) {
+        const geo::Coordinates point = stops[i]->coordinates;
+        const auto actual_nearest = actual.GetStopIndex().FindNearest(point, 5);
+        const auto expected_nearest = expected.GetStopIndex().FindNearest(point, 5);
+        ASSERT_EQUAL(actual_nearest.size(), expected_nearest.size());
+        for (size_t j = 0; j < expected_nearest.size(); ++j) {
+            ASSERT_EQUAL(actual_nearest[j].stop->name, expected_nearest[j].stop->name);
+        }
+        const std::string_view prefix = stops[i]->name.substr(0, 7);
+        ASSERT_EQUAL(GetNames(actual.GetStopSearch().FindByPrefix(prefix, 20)),
+                     GetNames(expected.GetStopSearch().FindByPrefix(prefix, 20)));
+        const std::string_view other = stops[(i * 7 + 3) % stops.size()]->name;
+        ASSERT_EQUAL(actual.GetDirectBuses(stops[i]->name, other), expected.GetDirectBuses(stops[i]->name, other));
+    }
+}
+
+} // namespace
+
+TEST(CatalogueUpdateMatchesFullLoad) {
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        const TestNetwork base = MakeRandomNetwork(seed, 100, 20, 8);
+        const TestNetwork delta = MakeRandomDelta(base, seed + 100, seed % 2 == 0 ? 0 : 10, seed % 3 == 0 ? 0 : 5, 10);
+        TransportCatalogue updated;
+        updated.Load(base.data);
+        updated.Update(delta.data);
+        TransportCatalogue loaded;
+        loaded.Load(Merge(base.data, delta.data));
+        AssertSameCatalogue(updated, loaded);
+        AssertSameIndexes(updated, loaded);
+    }
+}
+
+TEST(CatalogueUpdateReportsChanges) {
+    TestNetwork base;
+    const std::string_view a = base.AddStop("A", {55.70, 37.60});
+    const std::string_view b = base.AddStop("B", {55.71, 37.60});
+    const std::string_view c = base.AddStop("C", {55.72, 37.60});
+    base.AddDistance(a, b, 1000);
+    base.AddDistance(b, c, 1000);
+    base.AddBus("1", {a, b}, false);
+    base.AddBus("2", {b, c}, false);
+    TransportCatalogue db;
+    db.Load(base.data);
+
+    TestNetwork delta;
+    const std::string_view d = delta.AddStop("D", {55.73, 37.60});
+    delta.AddDistance(c, d, 800);
+    //A→B меняется, B→C задано то же самое
+    delta.AddDistance(a, b, 1500);
+    delta.AddDistance(b, c, 1000);
+    delta.AddBus("3", {c, d}, false);
+    const CatalogueChanges changes = db.Update(delta.data);
+
+    ASSERT_EQUAL(changes.added_stops.size(), 1u);
+    ASSERT_EQUAL(changes.added_stops[0]->name, "D"sv);
+    ASSERT_EQUAL(changes.added_buses.size(), 1u);
+    ASSERT_EQUAL(changes.added_buses[0]->name, "3"sv);
+    ASSERT_EQUAL(changes.changed_buses.size(), 1u);
+    ASSERT_EQUAL(changes.changed_buses[0]->name, "1"sv);
+    ASSERT_EQUAL(db.GetBusInfo("1"sv).route_length, 1500 + 1500);
+    ASSERT_EQUAL(db.GetBusInfo("2"sv).route_length, 2000);
+    ASSERT_EQUAL(db.GetBusesOnStop("C"sv), std::optional(std::vector{"2"sv, "3"sv}));
+    ASSERT_EQUAL(db.GetBusesOnStop("D"sv), std::optional(std::vector{"3"sv}));
+}
+
+TEST(CatalogueUpdateRejectsInvalidDeltas) {
+    const TestNetwork base = MakeRandomNetwork(5, 20, 4, 4);
+    TransportCatalogue db;
+    db.Load(base.data);
+    TransportCatalogue before(db);
+
+    std::vector<TestNetwork> deltas(7);
+    //Существующая остановка
+    deltas[0].AddStop("Stop 1", {55.7, 37.6});
+    //Остановка дважды в одном пакете
+    deltas[1].AddStop("Twice", {55.7, 37.6});
+    deltas[1].AddStop("Twice", {55.8, 37.6});
+    //Существующий маршрут
+    deltas[2].AddBus("Bus 0", {"Stop 1"sv, "Stop 2"sv}, false);
+    //Маршрут через неизвестную остановку; новая остановка пакета перед ним не должна добавиться
+    deltas[3].AddStop("New", {55.7, 37.6});
+    deltas[3].AddBus("New bus", {"New"sv, "Unknown"sv}, false);
+    //Расстояние до неизвестной остановки
+    deltas[4].AddDistance("Stop 1"sv, "Unknown"sv, 100);
+    //Отрицательное расстояние
+    deltas[5].AddDistance("Stop 1"sv, "Stop 2"sv, -100);
+    //Маршрут дважды в одном пакете
+    deltas[6].AddBus("Same", {"Stop 1"sv, "Stop 2"sv}, false);
+    deltas[6].AddBus("Same", {"Stop 2"sv, "Stop 3"sv}, false);
+
+    for (const TestNetwork& delta : deltas) {
+        ASSERT_THROWS(db.Update(delta.data), std::invalid_argument);
+        AssertSameCatalogue(db, before);
+        AssertSameIndexes(db, before);
+    }
+}
+
+TEST(RouterUpdateMatchesReference) {
+    for (double walk_distance : {0.0, 700.0}) {
+        const TestNetwork base = MakeRandomNetwork(6, 60, 10, 6);
+        TransportCatalogue db;
+        db.Load(base.data);
+        routing::RoutingSettings settings;
+        settings.walk_transfer_distance = walk_distance;
+        routing::TransportRouter router(db, settings);
+        //Несколько пакетов подряд: маршрутизатор дополняется после каждого
+        std::vector<TestNetwork> deltas;
+        deltas.reserve(3);
+        for (unsigned seed = 1; seed <= 3; ++seed) {
+            deltas.push_back(MakeRandomDelta(base, seed, 4, 2, 0));
+            router.Update(db.Update(deltas.back().data));
+            AssertSameRouteTimes(db, router, ReferenceRouter(db, settings));
+        }
+    }
+}
+
+TEST(RouterUpdateRecomputesChangedBuses) {
+    const TestNetwork base = MakeRandomNetwork(7, 50, 10, 6);
+    std::mt19937 generator(8);
+    for (int factor : {2, -2}) {
+        TransportCatalogue db;
+        db.Load(base.data);
+        const routing::RoutingSettings settings;
+        routing::TransportRouter router(db, settings);
+        //Расстояния на маршрутах становятся длиннее (таблица считается заново) или короче:
+        //одно укороченное расстояние даёт меньше подешевевших рёбер, чем вершин, и таблица дополняется
+        TestNetwork delta;
+        for (int i = 0; i < (factor > 0 ? 10 : 1); ++i) {
+            const Distance& distance = base.data.distances[generator() % base.data.distances.size()];
+            const int changed = factor > 0 ? distance.distance * factor : distance.distance / -factor;
+            delta.AddDistance(distance.from, distance.to, changed);
+        }
+        const CatalogueChanges changes = db.Update(delta.data);
+        ASSERT(!changes.changed_buses.empty());
+        router.Update(changes);
+        AssertSameRouteTimes(db, router, ReferenceRouter(db, settings));
+    }
+}
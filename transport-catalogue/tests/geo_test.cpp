@@ -0,0 +1,77 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "geo.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+namespace {
+
+std::vector<geo::Coordinates> MakeRandomPoints(unsigned seed, size_t count) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> lat(-89.0, 89.0);
+    std::uniform_real_distribution<double> lng(-180.0, 180.0);
+    std::vector<geo::Coordinates> result;
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back({lat(generator), lng(generator)});
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(SpherePointDistanceMatchesCoordinatesDistance) {
+    const std::vector<geo::Coordinates> points = MakeRandomPoints(1, 500);
+    for (size_t i = 1; i < points.size(); ++i) {
+        const double expected = geo::ComputeDistance(points[i - 1], points[i]);
+        const double actual = geo::ComputeDistance(geo::ToSpherePoint(points[i - 1]), geo::ToSpherePoint(points[i]));
+        //acos близ 1 теряет точность одинаково в обеих формулах: допускаем ошибку порядка метра
+        ASSERT(std::abs(actual - expected) < 1.0);
+    }
+    //Москва — Санкт-Петербург по дуге большого круга, около 634 км
+    const double distance = geo::ComputeDistance(geo::ToSpherePoint({55.7558, 37.6173}), geo::ToSpherePoint({59.9343, 30.3351}));
+    ASSERT(std::abs(distance - 634000) < 2000);
+}
+
+TEST(SpherePointDistanceStaysInRange) {
+    const geo::SpherePoint point = geo::ToSpherePoint({55.75, 37.62});
+    //Скалярное произведение точки на саму себя может чуть превысить 1
+    ASSERT_EQUAL(geo::ComputeDistance(point, point), 0.0);
+    const double antipodal = geo::ComputeDistance(point, geo::ToSpherePoint({-55.75, 37.62 - 180}));
+    ASSERT(std::abs(antipodal - M_PI * geo::EARTH_RADIUS) < 1e-3);
+    ASSERT(!std::isnan(antipodal));
+}
+
+TEST(BatchDistancesMatchScalar) {
+    const std::vector<geo::Coordinates> points = MakeRandomPoints(2, 1001);
+    std::vector<geo::SpherePoint> from;
+    std::vector<geo::SpherePoint> to;
+    for (size_t i = 1; i < points.size(); ++i) {
+        from.push_back(geo::ToSpherePoint(points[i - 1]));
+        to.push_back(geo::ToSpherePoint(points[i]));
+    }
+    //Одинаковые точки тоже попадают в пакет
+    from.push_back(from.front());
+    to.push_back(from.front());
+    std::vector<double> distances(from.size());
+    geo::ComputeDistances(from, to, distances);
+    for (size_t i = 0; i < distances.size(); ++i) {
+        ASSERT_EQUAL(distances[i], geo::ComputeDistance(from[i], to[i]));
+    }
+    geo::ComputeDistances({}, {}, {});
+}
+
+TEST(CatalogueCachesStopSpherePoints) {
+    const TestNetwork network = MakeRandomNetwork(3, 50, 5, 5);
+    TransportCatalogue db;
+    db.Load(network.data);
+    db.AddStop({"Extra", {55.7, 37.6}, {}});
+    for (const Stop* stop : db.GetStopsList()) {
+        const geo::SpherePoint expected = geo::ToSpherePoint(stop->coordinates);
+        ASSERT_EQUAL(stop->position.x, expected.x);
+        ASSERT_EQUAL(stop->position.y, expected.y);
+        ASSERT_EQUAL(stop->position.z, expected.z);
+    }
+}
@@ -0,0 +1,96 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+#include "json_network.h"
+#include "json_reader.h"
+#include "random_json.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Пробельные символы вне строк
+size_t CountSpacesOutsideStrings(std::string_view text) {
+    size_t count = 0;
+    bool in_string = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (in_string) {
+            if (text[i] == '\\') {
+                ++i;
+            } else if (text[i] == '"') {
+                in_string = false;
+            }
+        } else if (text[i] == '"') {
+            in_string = true;
+        } else if (text[i] == ' ' || text[i] == '\n') {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(JsonCompactPrintHasNoWhitespace) {
+    const json::Node node = json::Dict{
+        {"a"s, json::Array{1, 2.5, "x y"s, nullptr, true}},
+        {"b"s, json::Dict{{"c"s, json::Array{}}, {"d"s, json::Dict{}}}},
+    };
+    ASSERT_EQUAL(PrintJson(node, json::PrintFormat::COMPACT), R"({"a":[1,2.5,"x y",null,true],"b":{"c":[],"d":{}}})"s);
+    ASSERT_EQUAL(PrintJson(node), "{\n    \"a\": [\n        1,\n        2.5,\n        \"x y\",\n        null,\n        true\n    ],\n"
+                                  "    \"b\": {\n        \"c\": [\n\n        ],\n        \"d\": {\n\n        }\n    }\n}"s);
+
+    std::mt19937 generator(9);
+    for (int i = 0; i < 300; ++i) {
+        const json::Node random = MakeRandomJson(generator, 4);
+        const std::string compact = PrintJson(random, json::PrintFormat::COMPACT);
+        ASSERT_EQUAL(CountSpacesOutsideStrings(compact), 0u);
+        //Оба вида читаются в тот же документ
+        ASSERT(json::Load(compact).GetRoot() == random);
+        ASSERT(json::Load(compact) == json::Load(PrintJson(random)));
+    }
+}
+
+TEST(JsonPrintEscapesLargePayloads) {
+    //Как в ответе Map: большой текст SVG, где кавычки в каждом атрибуте
+    std::string svg = "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">\n"s;
+    for (int i = 0; i < 2000; ++i) {
+        svg += "  <circle cx=\""s + std::to_string(i) + "\" cy=\"5\" r=\"3\" fill=\"white\"/>\n\t<text>\\ "s + std::to_string(i) + "</text>\r\n"s;
+    }
+    svg += "</svg>"s;
+    std::ostringstream out;
+    json::PrintString(svg, out);
+    const std::string printed = out.str();
+    //Внутри нет сырых переводов строк и табуляций, а разбор возвращает исходный текст
+    ASSERT_EQUAL(printed.find_first_of("\n\r\t"sv), std::string::npos);
+    ASSERT_EQUAL(json::Load(printed).GetRoot().AsString(), svg);
+}
+
+TEST(JsonReaderPrintsCompactResponses) {
+    const TestNetwork network = MakeRandomNetwork(92, 30, 6, 5);
+    json::Array requests;
+    int id = 0;
+    for (const Stop& stop : network.data.stops) {
+        requests.push_back(json::Dict{{"id"s, ++id}, {"type"s, "Route"s}, {"from"s, "Stop 0"s}, {"to"s, std::string(stop.name)}});
+    }
+    requests.push_back(json::Dict{{"id"s, ++id}, {"type"s, "Map"s}});
+    const std::string input = MakeInputDocument(network.data, requests);
+    json::JsonReader reader{std::string_view(input)};
+    const TransportCatalogue& db = reader.MakeDB();
+    const routing::TransportRouter router(db, reader.ParseRoutingSettings());
+    const std::string_view map = "<svg>\n  <text>\"A\"</text>\n</svg>"sv;
+    std::ostringstream pretty;
+    reader.PrintJson(pretty, router, map, {});
+    std::ostringstream compact;
+    reader.PrintJson(compact, router, map, {}, json::PrintFormat::COMPACT);
+    ASSERT_EQUAL(CountSpacesOutsideStrings(compact.str()), 0u);
+    ASSERT(compact.str().size() < pretty.str().size());
+    ASSERT(json::Load(compact.str()) == json::Load(pretty.str()));
+    ASSERT(json::Load(compact.str()).GetRoot().AsArray().back().AsMap().at("map"sv) == json::Node(std::string(map)));
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::vector<std::string> GetKeys(const json::Dict& dict) {
+    std::vector<std::string> keys;
+    for (const auto& [key, value] : dict) {
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+} // namespace
+
+TEST(FlatMapMatchesStdMap) {
+    std::mt19937 generator(3);
+    json::FlatMap<std::string, int> flat;
+    std::map<std::string, int> expected;
+    for (int i = 0; i < 2000; ++i) {
+        const std::string key = std::to_string(generator() % 500);
+        const int value = static_cast<int>(generator() % 100);
+        //Как и у std::map, существующее значение не заменяется
+        ASSERT_EQUAL(flat.emplace(key, value).second, expected.emplace(key, value).second);
+        ASSERT_EQUAL(flat.size(), expected.size());
+    }
+    ASSERT(std::equal(flat.begin(), flat.end(), expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first == rhs.first && lhs.second == rhs.second;
+    }));
+    for (int i = 0; i < 600; ++i) {
+        const std::string key = std::to_string(i);
+        ASSERT_EQUAL(flat.count(std::string_view(key)), expected.count(key));
+        if (expected.count(key)) {
+            ASSERT_EQUAL(flat.at(std::string_view(key)), expected.at(key));
+            ASSERT_EQUAL(flat.find(key)->second, expected.at(key));
+        } else {
+            ASSERT(flat.find(std::string_view(key)) == flat.end());
+            ASSERT_THROWS(flat.at(std::string_view(key)), std::out_of_range);
+        }
+    }
+    flat["new"s] = 5;
+    ASSERT_EQUAL(flat.at("new"sv), 5);
+    ASSERT_EQUAL(flat["new"s], 5);
+}
+
+TEST(FlatMapFromInitializerListIsSorted) {
+    const json::Dict dict{{"b"s, 2}, {"a"s, 1}, {"c"s, 3}, {"a"s, 10}};
+    ASSERT_EQUAL(GetKeys(dict), (std::vector{"a"s, "b"s, "c"s}));
+    ASSERT(dict.at("a"sv) == json::Node(1));
+    ASSERT(dict == (json::Dict{{"c"s, 3}, {"b"s, 2}, {"a"s, 1}}));
+}
+
+TEST(JsonDictKeysAreSortedOnLoad) {
+    //Ключи в обратном порядке, вразнобой и с общими началами
+    const json::Node root = json::Load(R"({"z": 1, "b": {"y": 2, "x": 3}, "ab": 4, "a": 5, "": 6})"sv).GetRoot();
+    ASSERT_EQUAL(GetKeys(root.AsMap()), (std::vector{""s, "a"s, "ab"s, "b"s, "z"s}));
+    ASSERT_EQUAL(GetKeys(root.AsMap().at("b"sv).AsMap()), (std::vector{"x"s, "y"s}));
+    ASSERT(root.AsMap().at("ab"sv) == json::Node(4));
+
+    std::mt19937 generator(4);
+    std::vector<int> keys(300);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = static_cast<int>(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), generator);
+    std::string input = "{";
+    for (int key : keys) {
+        input += (input.size() > 1 ? ","s : ""s) + "\"" + std::to_string(key) + "\": " + std::to_string(key);
+    }
+    const json::Dict dict = json::Load(input + "}").GetRoot().AsMap();
+    ASSERT_EQUAL(dict.size(), keys.size());
+    ASSERT(std::is_sorted(dict.begin(), dict.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    }));
+    for (int key : keys) {
+        ASSERT(dict.at(std::to_string(key)) == json::Node(key));
+    }
+}
+
+TEST(JsonDictRejectsDuplicateKeys) {
+    for (const std::string_view input : {R"({"a": 1, "a": 2})"sv, R"({"b": 1, "a": 2, "b": 3})"sv,
+                                         R"([{"x": {"k": 1, "k": 1}}])"sv}) {
+        ASSERT_THROWS(json::Load(input), json::ParsingError);
+    }
+    //Одинаковые ключи в разных словарях допустимы
+    ASSERT(json::Load(R"({"a": {"a": 1}, "b": {"a": 2}})"sv).GetRoot().AsMap().at("b"sv).AsMap().at("a"sv) == json::Node(2));
+}
+
+TEST(JsonDictMemoryIsOneBlockPerObject) {
+    const json::Node root = json::Load(R"({"a": 1, "b": 2, "c": {"d": 3}})"sv).GetRoot();
+    const memory::Usage usage = json::ComputeMemoryUsage(root);
+    //Корень, три значения и одно вложенное
+    ASSERT_EQUAL(usage.items, 5u);
+    //Словарь занимает ровно столько пар, сколько в нём ключей
+    ASSERT_EQUAL(root.AsMap().capacity(), 3u);
+    ASSERT_EQUAL(usage.bytes, 4 * sizeof(json::Dict::value_type));
+}
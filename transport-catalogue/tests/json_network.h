@@ -0,0 +1,66 @@
+#pragma once
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+#include "test_network.h"
+
+/*
+ * Входной документ программы для тестовой сети: base_requests с теми же остановками,
+ * расстояниями и маршрутами, что data, настройки и заданные stat_requests.
+ * Повторно заданное расстояние в data заменяет прежнее, поэтому в road_distances попадает последнее.
+ */
+inline json::Array MakeBaseRequests(const CatalogueData& data) {
+    std::map<std::string_view, json::Dict> road_distances;
+    for (const Distance& distance : data.distances) {
+        road_distances[distance.from][std::string(distance.to)] = distance.distance;
+    }
+    json::Array requests;
+    for (const Stop& stop : data.stops) {
+        requests.push_back(json::Dict{
+            {"type", "Stop"},
+            {"name", std::string(stop.name)},
+            {"latitude", stop.coordinates.lat},
+            {"longitude", stop.coordinates.lng},
+            {"road_distances", road_distances[stop.name]},
+        });
+    }
+    for (const Bus& bus : data.buses) {
+        //У некольцевого маршрута в data уже есть обратный путь, в запросе — только прямой
+        const size_t size = bus.is_circle ? bus.stops.size() : (bus.stops.size() + 1) / 2;
+        json::Array stops;
+        for (size_t i = 0; i < size; ++i) {
+            stops.push_back(std::string(bus.stops[i]));
+        }
+        requests.push_back(json::Dict{
+            {"type", "Bus"},
+            {"name", std::string(bus.name)},
+            {"stops", stops},
+            {"is_roundtrip", bus.is_circle},
+        });
+    }
+    return requests;
+}
+
+inline std::string MakeInputDocument(const CatalogueData& data, const json::Array& stat_requests = {}) {
+    const json::Node document = json::Dict{
+        {"base_requests", MakeBaseRequests(data)},
+        {"render_settings", json::Dict{
+            {"width", 200}, {"height", 200}, {"padding", 30}, {"line_width", 14}, {"stop_radius", 5},
+            {"bus_label_font_size", 20}, {"bus_label_offset", json::Array{7, 15}},
+            {"stop_label_font_size", 20}, {"stop_label_offset", json::Array{7, -3}},
+            {"underlayer_color", json::Array{255, 255, 255, 0.85}}, {"underlayer_width", 3},
+            {"color_palette", json::Array{"green", json::Array{255, 160, 0}, "red"}},
+        }},
+        {"routing_settings", json::Dict{{"bus_wait_time", 6}, {"bus_velocity", 40}}},
+        {"stat_requests", stat_requests},
+    };
+    std::ostringstream out;
+    //Координаты без потери точности: иначе справочник из документа не совпадёт с data
+    out.precision(17);
+    json::Print(json::Document{document}, out, json::PrintFormat::COMPACT);
+    return out.str();
+}
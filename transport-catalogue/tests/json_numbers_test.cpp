@@ -0,0 +1,131 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Вывод через поток с теми же настройками — прежнее поведение Print
+template <typename Number>
+void AssertPrintedAsStream(Number value, const std::ostringstream& format) {
+    std::ostringstream expected;
+    expected.copyfmt(format);
+    expected << value;
+    std::ostringstream actual;
+    actual.copyfmt(format);
+    json::PrintNumber(value, actual);
+    ASSERT_EQUAL(actual.str(), expected.str());
+}
+
+//Прежний разбор: std::stoi, при переполнении std::stod, ошибки stod — ParsingError
+json::Node ParseAsBefore(const std::string& number) {
+    const bool is_int = number.find_first_of(".eE"sv) == std::string::npos;
+    if (is_int) {
+        try {
+            return std::stoi(number);
+        } catch (...) {
+        }
+    }
+    try {
+        return std::stod(number);
+    } catch (...) {
+        throw json::ParsingError("Failed to convert "s + number + " to number"s);
+    }
+}
+
+bool IsSameBits(double lhs, double rhs) {
+    return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+}
+
+} // namespace
+
+TEST(JsonPrintNumberMatchesStream) {
+    std::ostringstream formats[5];
+    formats[1].precision(17);
+    formats[2].precision(1);
+    //Нестандартный формат выводится самим потоком
+    formats[3] << std::fixed;
+    formats[4] << std::showpos << std::scientific;
+    std::mt19937_64 generator(6);
+    for (const std::ostringstream& format : formats) {
+        for (int value : {0, 1, -1, 42, std::numeric_limits<int>::max(), std::numeric_limits<int>::min()}) {
+            AssertPrintedAsStream(value, format);
+        }
+        for (double value : {0.0, -0.0, 1.0, -2.5, 0.1, 1e-7, 123456.0, 1234567.0, 1e21, 5e-324,
+                             std::numeric_limits<double>::max(), std::numeric_limits<double>::infinity()}) {
+            AssertPrintedAsStream(value, format);
+        }
+        for (int i = 0; i < 2000; ++i) {
+            //Случайные биты дают числа всех порядков
+            const uint64_t bits = generator();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            if (!std::isnan(value)) {
+                AssertPrintedAsStream(value, format);
+            }
+        }
+    }
+}
+
+TEST(JsonNumbersRoundTrip) {
+    std::mt19937_64 generator(7);
+    std::ostringstream out;
+    out.precision(17);
+    for (int i = 0; i < 5000; ++i) {
+        const uint64_t bits = generator();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value) || std::fpclassify(value) == FP_SUBNORMAL) {
+            continue;
+        }
+        out.str({});
+        json::Print(json::Document{value}, out);
+        const json::Node parsed = json::Load(out.str()).GetRoot();
+        //17 значащих цифр восстанавливают double точно; целые значения читаются как int
+        ASSERT(IsSameBits(parsed.AsDouble(), value) || (parsed.IsInt() && parsed.AsDouble() == value));
+    }
+}
+
+TEST(JsonLoadNumberMatchesStod) {
+    std::mt19937 generator(8);
+    const std::string digits = "0123456789";
+    for (int i = 0; i < 5000; ++i) {
+        //Числа по грамматике JSON: знак, целая часть без ведущих нулей, дробь, порядок
+        std::string number = generator() % 2 ? "-"s : ""s;
+        const size_t int_size = 1 + generator() % 12;
+        number += static_cast<char>('1' + generator() % 9);
+        for (size_t j = 1; j < int_size; ++j) {
+            number += digits[generator() % 10];
+        }
+        if (generator() % 2) {
+            number += '.';
+            for (size_t j = 1 + generator() % 20; j > 0; --j) {
+                number += digits[generator() % 10];
+            }
+        }
+        if (generator() % 3 == 0) {
+            number += "eE"[generator() % 2];
+            number += std::string_view("+-").substr(generator() % 3, 1);
+            number += std::to_string(generator() % 330);
+        }
+        json::Node expected;
+        try {
+            expected = ParseAsBefore(number);
+        } catch (const json::ParsingError&) {
+            ASSERT_THROWS(json::Load(number), json::ParsingError);
+            continue;
+        }
+        const json::Node parsed = json::Load(number).GetRoot();
+        ASSERT_EQUAL(parsed.IsInt(), expected.IsInt());
+        ASSERT(IsSameBits(parsed.AsDouble(), expected.AsDouble()));
+    }
+}
@@ -0,0 +1,81 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+#include "random_json.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+json::Node LoadNode(std::string_view input) {
+    return json::Load(input).GetRoot();
+}
+
+} // namespace
+
+TEST(JsonLoadsAllValueTypes) {
+    const json::Node expected = json::Dict{
+        {"array"s, json::Array{1, -2.5, "x"s, nullptr, json::Array{}}},
+        {"bool"s, json::Array{true, false}},
+        {"dict"s, json::Dict{{"inner"s, json::Dict{}}}},
+        {"int"s, -42},
+        {"double"s, 0.25},
+        {"exponent"s, 1.5e3},
+        {"null"s, nullptr},
+        {"string"s, "a\"b\\c\nd\re\tf/я"s},
+    };
+    const std::string input = R"( { "array" : [1, -2.5, "x", null, [ ]], "bool": [true,false],
+        "dict": {"inner": {}}, "int": -42, "double": 0.25, "exponent": 1.5E+3, "null": null,
+        "string": "a\"b\\c\nd\re\tf/я" } )"s;
+    ASSERT(LoadNode(input) == expected);
+    std::istringstream stream(input);
+    ASSERT(json::Load(stream).GetRoot() == expected);
+    //Разбирается только первое значение
+    ASSERT(LoadNode("[1] trailing"sv) == json::Node(json::Array{1}));
+    ASSERT(LoadNode("\t\n 7"sv) == json::Node(7));
+}
+
+TEST(JsonLoadRoundTripsPrintedDocuments) {
+    std::mt19937 generator(1);
+    for (int i = 0; i < 300; ++i) {
+        const json::Node node = MakeRandomJson(generator, 4);
+        for (const json::PrintFormat format : {json::PrintFormat::PRETTY, json::PrintFormat::COMPACT}) {
+            const std::string printed = PrintJson(node, format);
+            ASSERT(LoadNode(printed) == node);
+            std::istringstream stream(printed);
+            ASSERT(json::Load(stream).GetRoot() == node);
+        }
+    }
+}
+
+TEST(JsonLoadRejectsInvalidInput) {
+    for (const std::string_view input : {
+             ""sv, "   "sv, "["sv, "[1, 2"sv, "{"sv, R"({"a" 1})"sv, R"({"a": 1)"sv, "{1: 2}"sv,
+             R"("abc)"sv, R"("a\x")"sv, "\"a\\"sv, "\"line\nbreak\""sv,
+             "\"line\rbreak\""sv, "tru"sv, "True"sv, "nul"sv, "nulll"sv, "-"sv, "1."sv, "1e"sv,
+             "1e+"sv, ".5"sv, "+1"sv, "1e400"sv}) {
+        ASSERT_THROWS(LoadNode(input), json::ParsingError);
+    }
+    //Как и прежний разбор из потока, пропущенные запятые между элементами не считаются ошибкой
+    ASSERT(LoadNode(R"({"a": 1 "b": 2})"sv) == json::Node(json::Dict{{"a"s, 1}, {"b"s, 2}}));
+    ASSERT(LoadNode("[1 2]"sv) == json::Node(json::Array{1, 2}));
+}
+
+TEST(JsonLoadParsesNumbers) {
+    ASSERT(LoadNode("0"sv) == json::Node(0));
+    ASSERT(LoadNode("-0"sv) == json::Node(0));
+    ASSERT(LoadNode("2147483647"sv) == json::Node(2147483647));
+    ASSERT(LoadNode("-2147483648"sv) == json::Node(-2147483647 - 1));
+    //За пределами int — double
+    ASSERT(LoadNode("2147483648"sv) == json::Node(2147483648.0));
+    ASSERT(LoadNode("-2147483649"sv) == json::Node(-2147483649.0));
+    ASSERT(LoadNode("1e2"sv) == json::Node(100.0));
+    ASSERT(LoadNode("1.0"sv) == json::Node(1.0));
+    ASSERT(LoadNode("-0.000125"sv) == json::Node(-0.000125));
+    //После 0 число заканчивается
+    ASSERT(LoadNode("[01]"sv) == json::Node(json::Array{0, 1}));
+}
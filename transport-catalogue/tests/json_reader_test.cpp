@@ -0,0 +1,116 @@
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "json.h"
+#include "json_network.h"
+#include "json_reader.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+json::Array MakeNameRequests(const TestNetwork& network) {
+    json::Array requests;
+    int id = 0;
+    for (const Bus& bus : network.data.buses) {
+        requests.push_back(json::Dict{{"id"s, ++id}, {"type"s, "Bus"s}, {"name"s, std::string(bus.name)}});
+    }
+    for (const Stop& stop : network.data.stops) {
+        requests.push_back(json::Dict{{"id"s, ++id}, {"type"s, "Stop"s}, {"name"s, std::string(stop.name)}});
+    }
+    requests.push_back(json::Dict{{"id"s, ++id}, {"type"s, "Bus"s}, {"name"s, "No such bus"s}});
+    requests.push_back(json::Dict{{"id"s, ++id}, {"type"s, "Stop"s}, {"name"s, "No such stop"s}});
+    return requests;
+}
+
+json::Array PrintResponses(json::JsonReader& reader) {
+    const TransportCatalogue& db = reader.MakeDB();
+    const routing::TransportRouter router(db, reader.ParseRoutingSettings());
+    std::ostringstream out;
+    reader.PrintJson(out, router, ""sv, {});
+    return json::Load(out.str()).GetRoot().AsArray();
+}
+
+} // namespace
+
+TEST(JsonReaderAnswersBusAndStopRequests) {
+    const TestNetwork network = MakeRandomNetwork(91, 60, 15, 6);
+    TransportCatalogue expected;
+    expected.Load(network.data);
+    const json::Array requests = MakeNameRequests(network);
+    const std::string input = MakeInputDocument(network.data, requests);
+    json::JsonReader reader{std::string_view(input)};
+    const json::Array responses = PrintResponses(reader);
+
+    ASSERT_EQUAL(responses.size(), requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const json::Dict& request = requests[i].AsMap();
+        const json::Dict& response = responses[i].AsMap();
+        ASSERT(response.at("request_id"sv) == request.at("id"sv));
+        const std::string& name = request.at("name"sv).AsString();
+        if (request.at("type"sv).AsString() == "Bus"sv) {
+            const BusInfo info = expected.GetBusInfo(name);
+            if (!info.stops_on_route) {
+                ASSERT(response.at("error_message"sv) == json::Node("not found"s));
+                continue;
+            }
+            ASSERT(response.at("stop_count"sv) == json::Node(static_cast<int>(info.stops_on_route)));
+            ASSERT(response.at("unique_stop_count"sv) == json::Node(static_cast<int>(info.unique_stops)));
+            ASSERT(response.at("route_length"sv) == json::Node(info.route_length));
+            //Кривизна выводится с 6 значащими цифрами
+            ASSERT(std::abs(response.at("curvature"sv).AsDouble() - info.curvature) < 1e-5 * info.curvature);
+        } else {
+            const auto buses = expected.GetBusesOnStop(name);
+            if (!buses) {
+                ASSERT(response.at("error_message"sv) == json::Node("not found"s));
+                continue;
+            }
+            json::Array names;
+            for (std::string_view bus : *buses) {
+                names.push_back(std::string(bus));
+            }
+            ASSERT(response.at("buses"sv) == json::Node(names));
+        }
+    }
+    ASSERT(responses.back().AsMap().count("error_message"sv));
+}
+
+TEST(JsonReaderParsesSettings) {
+    const std::string input = MakeInputDocument({});
+    const json::JsonReader reader{std::string_view(input)};
+    const renderer::RenderSettings render = reader.ParseRenderSettings();
+    ASSERT_EQUAL(render.width, 200.0);
+    ASSERT_EQUAL(render.padding, 30.0);
+    ASSERT_EQUAL(render.bus_label_font_size, 20);
+    ASSERT_EQUAL(render.stop_label_offset[1], -3.0);
+    ASSERT_EQUAL(render.color_palette.size(), 3u);
+    ASSERT_EQUAL(std::get<std::string>(render.color_palette[0]), "green"s);
+    ASSERT_EQUAL(std::get<svg::Rgba>(render.underlayer_color).opacity, 0.85);
+    const routing::RoutingSettings routing = reader.ParseRoutingSettings();
+    ASSERT_EQUAL(routing.bus_wait_time, 6);
+    ASSERT_EQUAL(routing.bus_velocity, 40);
+    //Неизвестный тип запроса отклоняется при разборе stat_requests
+    const std::string unknown = MakeInputDocument({}, json::Array{json::Dict{{"id"s, 1}, {"type"s, "Unknown"s}}});
+    json::JsonReader unknown_reader{std::string_view(unknown)};
+    ASSERT_THROWS(PrintResponses(unknown_reader), std::invalid_argument);
+}
+
+TEST(JsonDictLookupByStringView) {
+    const json::Dict dict = json::Load(R"({"name": 1, "name2": 2, "nam": 3})"sv).GetRoot().AsMap();
+    //Ключ — часть большей строки без завершающего нуля
+    const std::string_view source = "name2name"sv;
+    ASSERT(dict.at(source.substr(0, 4)) == json::Node(1));
+    ASSERT(dict.at(source.substr(0, 5)) == json::Node(2));
+    ASSERT(dict.at(source.substr(0, 3)) == json::Node(3));
+    ASSERT_EQUAL(dict.count(source.substr(5)), 1u);
+    ASSERT_EQUAL(dict.count(source.substr(1, 3)), 0u);
+    ASSERT_THROWS(dict.at(source.substr(1)), std::out_of_range);
+}
@@ -0,0 +1,116 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+#include "random_json.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+/*
+ * Строки и пробелы разбираются блоками по 16 или 32 байта, в хвосте — по одному символу.
+ * Особые символы ставятся на каждую позицию строк разной длины, чтобы попасть
+ * и в начало, и в конец блока, и в хвост.
+ */
+
+namespace {
+
+constexpr size_t MAX_SIZE = 100;
+
+//Экранирование посимвольно, как у Print
+std::string EscapeByChars(std::string_view value) {
+    std::string result = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '\n':
+                result += "\\n"sv;
+                break;
+            case '\r':
+                result += "\\r"sv;
+                break;
+            case '\t':
+                result += "\\t"sv;
+                break;
+            case '"':
+            case '\\':
+                result += '\\';
+                result += c;
+                break;
+            default:
+                result += c;
+        }
+    }
+    return result + '"';
+}
+
+std::string PrintString(std::string_view value) {
+    std::ostringstream out;
+    json::PrintString(value, out);
+    return out.str();
+}
+
+} // namespace
+
+TEST(JsonStringEscapesAtEveryOffset) {
+    for (size_t size = 1; size <= MAX_SIZE; ++size) {
+        for (size_t position = 0; position < size; ++position) {
+            for (const auto& [escaped, value] : {std::pair{"\\\""sv, '"'}, {"\\\\"sv, '\\'}, {"\\n"sv, '\n'},
+                                                 {"\\r"sv, '\r'}, {"\\t"sv, '\t'}}) {
+                std::string expected(size, 'x');
+                expected[position] = value;
+                const std::string input = "\""s + std::string(position, 'x') + std::string(escaped)
+                    + std::string(size - position - 1, 'x') + "\""s;
+                ASSERT_EQUAL(json::Load(input).GetRoot().AsString(), expected);
+                ASSERT_EQUAL(PrintString(expected), input);
+            }
+            //Перевод строки без экранирования и строка без закрывающей кавычки
+            std::string broken = "\""s + std::string(size, 'x') + "\""s;
+            broken[position + 1] = '\n';
+            ASSERT_THROWS(json::Load(broken), json::ParsingError);
+            ASSERT_THROWS(json::Load("\""s + std::string(size, 'x')), json::ParsingError);
+        }
+    }
+}
+
+TEST(JsonStringKeepsOtherBytes) {
+    //Все байты, кроме особых, в том числе старшие (UTF-8) и управляющие
+    std::string value;
+    for (int c = 1; c < 256; ++c) {
+        if (c != '"' && c != '\\' && c != '\n' && c != '\r') {
+            value += static_cast<char>(c);
+        }
+    }
+    for (size_t shift = 0; shift < 40; ++shift) {
+        const std::string shifted = std::string(shift, ' ') + value;
+        ASSERT_EQUAL(json::Load("\""s + shifted + "\""s).GetRoot().AsString(), shifted);
+        ASSERT_EQUAL(PrintString(shifted), EscapeByChars(shifted));
+    }
+}
+
+TEST(JsonPrintStringMatchesCharByCharEscaping) {
+    std::mt19937 generator(2);
+    for (int i = 0; i < 2000; ++i) {
+        const std::string value = MakeRandomJsonString(generator, 150);
+        ASSERT_EQUAL(PrintString(value), EscapeByChars(value));
+    }
+}
+
+TEST(JsonSkipsWhitespaceRuns) {
+    constexpr std::string_view SPACES = " \t\n\r\v\f"sv;
+    for (size_t size = 0; size <= MAX_SIZE; ++size) {
+        std::string spaces;
+        for (size_t i = 0; i < size; ++i) {
+            spaces += SPACES[i % SPACES.size()];
+        }
+        ASSERT(json::Load(spaces + "["s + spaces + "1"s + spaces + ","s + spaces + "2"s + spaces + "]"s).GetRoot()
+               == json::Node(json::Array{1, 2}));
+        ASSERT(json::Load(spaces + "{"s + spaces + "\"a\""s + spaces + ":"s + spaces + "null"s + spaces + "}"s).GetRoot()
+               == json::Node(json::Dict{{"a"s, nullptr}}));
+        //Байты, похожие на пробельные, не пропускаются
+        for (const char c : {'\0', '\x08', '\x0e', '\x1f', '\x7f', '\x85', '\xa0', '\xff'}) {
+            ASSERT_THROWS(json::Load(spaces + c + "1"s), json::ParsingError);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.h"
+#include "json_network.h"
+#include "json_reader.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Обработчики, собирающие элементы потоковых массивов по ключам
+struct Collected {
+    std::vector<json::Node> items;
+    std::vector<json::Node> other;
+
+    json::StreamHandlers MakeHandlers() {
+        return {
+            {"items"s, [this](json::Node item) { items.push_back(std::move(item)); }},
+            {"other"s, [this](json::Node item) { other.push_back(std::move(item)); }},
+        };
+    }
+};
+
+} // namespace
+
+TEST(JsonStreamingPassesRootArrayItems) {
+    Collected collected;
+    const json::Document document = json::LoadStreaming(
+        R"({"before": 1, "items": [1, "two", {"items": [3]}, [4]], "nested": {"items": [5]}, "other": "scalar"})"sv,
+        collected.MakeHandlers());
+    ASSERT_EQUAL(collected.items.size(), 4u);
+    ASSERT(collected.items[0] == json::Node(1));
+    ASSERT(collected.items[1] == json::Node("two"s));
+    //Одноимённые ключи ниже корня в поток не попадают
+    ASSERT(collected.items[2] == json::Node(json::Dict{{"items"s, json::Array{3}}}));
+    ASSERT(collected.items[3] == json::Node(json::Array{4}));
+    //Значение, которое не массив, остаётся в документе
+    ASSERT(collected.other.empty());
+    const json::Node expected = json::Dict{
+        {"before"s, 1},
+        {"items"s, json::Array{}},
+        {"nested"s, json::Dict{{"items"s, json::Array{5}}}},
+        {"other"s, "scalar"s},
+    };
+    ASSERT(document.GetRoot() == expected);
+}
+
+TEST(JsonStreamingMatchesLoad) {
+    const std::string input = R"(  [{"items": [1]}, 2]  )"s;
+    Collected collected;
+    //Корень не словарь: потоковых массивов нет
+    ASSERT(json::LoadStreaming(input, collected.MakeHandlers()) == json::Load(input));
+    ASSERT(collected.items.empty());
+    //Ошибка посреди массива: элементы до неё уже переданы
+    ASSERT_THROWS(json::LoadStreaming(R"({"items": [1, 2, tru]})"sv, collected.MakeHandlers()), json::ParsingError);
+    ASSERT_EQUAL(collected.items.size(), 2u);
+}
+
+TEST(JsonReaderStreamsBaseRequestsIntoCatalogue) {
+    const TestNetwork network = MakeRandomNetwork(81, 150, 30, 8);
+    TransportCatalogue expected;
+    expected.Load(network.data);
+    const std::string input = MakeInputDocument(network.data);
+
+    json::JsonReader reader{std::string_view(input)};
+    //До построения справочника в памяти только собранные запросы, но не их узлы JSON
+    const memory::Usage before = reader.GetDocumentMemoryUsage();
+    ASSERT_EQUAL(before.items, 150u + 30u + json::ComputeMemoryUsage(json::Load(input).GetRoot()).items
+                                 - json::ComputeMemoryUsage(json::Node(MakeBaseRequests(network.data))).items);
+    AssertSameCatalogue(reader.MakeDB(), expected);
+    //Справочник скопировал имена: собранные запросы освобождены
+    ASSERT(reader.GetDocumentMemoryUsage().bytes < before.bytes);
+}
@@ -0,0 +1,139 @@
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "json.h"
+#include "json_writer.h"
+#include "random_json.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Тот же узел, выведенный через Writer
+void WriteNode(json::Writer& writer, const json::Node& node) {
+    if (node.IsArray()) {
+        writer.StartArray();
+        for (const json::Node& item : node.AsArray()) {
+            WriteNode(writer, item);
+        }
+        writer.EndArray();
+    } else if (node.IsMap()) {
+        writer.StartDict();
+        for (const auto& [key, value] : node.AsMap()) {
+            writer.Key(key);
+            WriteNode(writer, value);
+        }
+        writer.EndDict();
+    } else if (node.IsString()) {
+        writer.Value(std::string_view(node.AsString()));
+    } else if (node.IsInt()) {
+        writer.Value(node.AsInt());
+    } else if (node.IsPureDouble()) {
+        writer.Value(node.AsDouble());
+    } else if (node.IsBool()) {
+        writer.Value(node.AsBool());
+    } else {
+        writer.Value(nullptr);
+    }
+}
+
+std::string Write(const json::Node& node, json::PrintFormat format) {
+    std::ostringstream out;
+    json::Writer writer(out, format);
+    WriteNode(writer, node);
+    return out.str();
+}
+
+//Контексты не дают вызвать метод, недопустимый в этом месте документа
+template <typename Context>
+concept AcceptsValue = requires(Context context) { context.Value(1); };
+template <typename Context>
+concept AcceptsKey = requires(Context context) { context.Key("key"sv); };
+template <typename Context>
+concept AcceptsEndDict = requires(Context context) { context.EndDict(); };
+template <typename Context>
+concept AcceptsEndArray = requires(Context context) { context.EndArray(); };
+
+using DictContext = decltype(std::declval<json::Writer&>().StartDict());
+using KeyContext = decltype(std::declval<json::Writer&>().Key("key"sv));
+using ArrayContext = decltype(std::declval<json::Writer&>().StartArray());
+
+static_assert(!AcceptsValue<DictContext> && AcceptsKey<DictContext> && AcceptsEndDict<DictContext> && !AcceptsEndArray<DictContext>);
+static_assert(AcceptsValue<KeyContext> && !AcceptsKey<KeyContext> && !AcceptsEndDict<KeyContext> && !AcceptsEndArray<KeyContext>);
+static_assert(AcceptsValue<ArrayContext> && !AcceptsKey<ArrayContext> && !AcceptsEndDict<ArrayContext> && AcceptsEndArray<ArrayContext>);
+//Значение после ключа возвращает к словарю, значение в массиве — к массиву
+static_assert(std::is_same_v<decltype(std::declval<KeyContext&>().Value(1)), DictContext>);
+static_assert(std::is_same_v<decltype(std::declval<ArrayContext&>().Value(1)), ArrayContext>);
+
+} // namespace
+
+TEST(JsonWriterMatchesPrint) {
+    std::mt19937 generator(5);
+    for (int i = 0; i < 300; ++i) {
+        const json::Node node = MakeRandomJson(generator, 4);
+        for (const json::PrintFormat format : {json::PrintFormat::PRETTY, json::PrintFormat::COMPACT}) {
+            ASSERT_EQUAL(Write(node, format), PrintJson(node, format));
+        }
+    }
+    //Пустые и вложенные пустые контейнеры
+    for (const json::Node& node : {json::Node(json::Array{}), json::Node(json::Dict{}),
+                                   json::Node(json::Array{json::Dict{}, json::Array{}}),
+                                   json::Node(json::Dict{{"a"s, json::Dict{}}, {"b"s, json::Array{}}})}) {
+        ASSERT_EQUAL(Write(node, json::PrintFormat::PRETTY), PrintJson(node, json::PrintFormat::PRETTY));
+        ASSERT_EQUAL(Write(node, json::PrintFormat::COMPACT), PrintJson(node, json::PrintFormat::COMPACT));
+    }
+}
+
+TEST(JsonWriterChainsContexts) {
+    std::ostringstream out;
+    json::Writer(out, json::PrintFormat::COMPACT).StartDict().
+        Key("a"sv).StartArray().Value(1).Value("x"sv).StartDict().EndDict().EndArray().
+        Key("b"sv).Value(2.5).
+        Key("c"sv).StartDict().Key("d"sv).Value(nullptr).EndDict().
+        EndDict();
+    ASSERT_EQUAL(out.str(), R"({"a":[1,"x",{}],"b":2.5,"c":{"d":null}})"s);
+}
+
+TEST(JsonWriterRejectsInvalidOrder) {
+    std::ostringstream out;
+    {
+        //Ключи не по алфавиту и повторный ключ
+        json::Writer writer(out);
+        writer.StartDict().Key("b"sv).Value(1);
+        ASSERT_THROWS(writer.Key("a"sv), std::logic_error);
+        ASSERT_THROWS(writer.Key("b"sv), std::logic_error);
+    }
+    {
+        //Второе значение в корне
+        json::Writer writer(out);
+        writer.Value(1);
+        ASSERT_THROWS(writer.Value(2), std::logic_error);
+        ASSERT_THROWS(writer.StartArray(), std::logic_error);
+    }
+    {
+        //Конец не того контейнера и лишний конец
+        json::Writer writer(out);
+        writer.StartArray();
+        ASSERT_THROWS(writer.EndDict(), std::logic_error);
+        writer.EndArray();
+        ASSERT_THROWS(writer.EndArray(), std::logic_error);
+    }
+    {
+        //Значение без ключа, ключ без значения, ключ в массиве
+        json::Writer writer(out);
+        writer.StartDict();
+        ASSERT_THROWS(writer.Value(1), std::logic_error);
+        writer.Key("a"sv);
+        ASSERT_THROWS(writer.EndDict(), std::logic_error);
+        ASSERT_THROWS(writer.Key("b"sv), std::logic_error);
+        writer.StartArray();
+        ASSERT_THROWS(writer.Key("c"sv), std::logic_error);
+    }
+}
@@ -0,0 +1,37 @@
+#include <exception>
+#include <iostream>
+#include <string_view>
+
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace testing {
+
+std::vector<TestCase>& GetTests() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+} // namespace testing
+
+//Запускает все тесты или только те, в имени которых есть первый аргумент
+int main(int argc, char* argv[]) {
+    const std::string_view filter = argc > 1 ? argv[1] : ""sv;
+    size_t run = 0;
+    size_t failed = 0;
+    for (const testing::TestCase& test : testing::GetTests()) {
+        if (test.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        ++run;
+        try {
+            test.body();
+        } catch (const std::exception& e) {
+            ++failed;
+            std::cerr << "FAIL "sv << test.name << ": "sv << e.what() << std::endl;
+        }
+    }
+    std::cerr << run << " tests, "sv << failed << " failed"sv << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "memory_usage.h"
+#include "serialization.h"
+#include "temp_file.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+memory::Usage FindPart(const memory::Report& report, const std::string& name) {
+    for (const auto& [part, usage] : report.parts) {
+        if (part == name) {
+            return usage;
+        }
+    }
+    throw testing::AssertionError("No part "s + name + " in the report"s);
+}
+
+bool HasPart(const memory::Report& report, const std::string& name) {
+    for (const auto& [part, usage] : report.parts) {
+        if (part == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(HeapBytesOfContainers) {
+    std::vector<double> vec;
+    vec.reserve(10);
+    ASSERT_EQUAL(memory::GetHeapBytes(vec), 10 * sizeof(double));
+    //Короткая строка целиком внутри объекта
+    ASSERT_EQUAL(memory::GetHeapBytes("short"s), 0u);
+    const std::string long_string(100, 'x');
+    ASSERT(memory::GetHeapBytes(long_string) > 100);
+
+    std::map<int, int> map;
+    std::set<int> set;
+    std::unordered_map<int, int> hash_map;
+    ASSERT_EQUAL(memory::GetHeapBytes(map), 0u);
+    for (int i = 0; i < 100; ++i) {
+        map[i] = i;
+        set.insert(i);
+        hash_map[i] = i;
+    }
+    //Каждый узел дерева больше своего элемента, а хеш-таблица держит ещё и корзины
+    ASSERT(memory::GetHeapBytes(map) > 100 * sizeof(std::pair<const int, int>));
+    ASSERT(memory::GetHeapBytes(set) > 100 * sizeof(int));
+    ASSERT(memory::GetHeapBytes(hash_map) >= 100 * sizeof(std::pair<const int, int>) + hash_map.bucket_count() * sizeof(void*));
+}
+
+TEST(ReportTotalsAndNesting) {
+    memory::Report nested;
+    nested.Add("graph", {100, 3});
+    nested.Add("routes", {50, 9});
+    memory::Report report;
+    report.Add("arena", {1000, 2});
+    report.Add("router", nested);
+    ASSERT_EQUAL(report.parts.size(), 3u);
+    ASSERT_EQUAL(report.parts[1].first, "router.graph"s);
+    ASSERT_EQUAL(report.parts[2].second.items, 9u);
+    ASSERT_EQUAL(report.GetTotalBytes(), 1150u);
+
+    std::ostringstream out;
+    memory::PrintSummary(out, {{"catalogue"s, report}, {"json"s, nested}});
+    ASSERT_EQUAL(out.str(), "Memory usage: catalogue=1150 json=150 total=1300 bytes"s);
+}
+
+TEST(CatalogueMemoryReportCountsRecords) {
+    const TestNetwork network = MakeRandomNetwork(51, 100, 20, 6);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const memory::Report report = db.GetMemoryUsage();
+    ASSERT_EQUAL(FindPart(report, "stops").items, 100u);
+    ASSERT_EQUAL(FindPart(report, "buses").items, 20u);
+    ASSERT_EQUAL(FindPart(report, "bus_infos").items, 20u);
+    ASSERT(FindPart(report, "route_lengths").items > 0);
+    ASSERT_EQUAL(FindPart(report, "stop_index").items, 100u);
+    ASSERT_EQUAL(FindPart(report, "stop_search").items, 100u);
+    ASSERT(FindPart(report, "arena").bytes > 0);
+    ASSERT(!HasPart(report, "external_distances"));
+
+    //Копия разделяет записи оригинала и не считает их своими
+    const TransportCatalogue copy(db);
+    ASSERT_EQUAL(FindPart(copy.GetMemoryUsage(), "arena").items, 0u);
+    ASSERT_EQUAL(FindPart(copy.GetMemoryUsage(), "stops").items, 100u);
+}
+
+TEST(MappedCatalogueReportsExternalDistances) {
+    const TestNetwork network = MakeRandomNetwork(52, 50, 10, 6);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const TempFile file("memory.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+    TransportCatalogue mapped;
+    serialization::MapCatalogue(file.GetPath(), mapped);
+    const memory::Report report = mapped.GetMemoryUsage();
+    ASSERT_EQUAL(FindPart(report, "route_lengths").items, 0u);
+    const memory::Usage external = FindPart(report, "external_distances");
+    ASSERT_EQUAL(external.bytes, 0u);
+    ASSERT_EQUAL(external.items, FindPart(db.GetMemoryUsage(), "route_lengths").items);
+}
+
+TEST(RouterMemoryReportGrowsWithGraph) {
+    const TestNetwork small_network = MakeRandomNetwork(53, 20, 4, 5);
+    const TestNetwork large_network = MakeRandomNetwork(53, 80, 16, 5);
+    TransportCatalogue small_db;
+    small_db.Load(small_network.data);
+    TransportCatalogue large_db;
+    large_db.Load(large_network.data);
+    const routing::TransportRouter small_router(small_db, routing::RoutingSettings{});
+    const routing::TransportRouter large_router(large_db, routing::RoutingSettings{});
+    const memory::Report report = small_router.GetMemoryUsage();
+    for (const std::string& part : {"graph.edges"s, "graph.incidence_lists"s, "routes"s, "profiles"s, "edge_items"s}) {
+        ASSERT(HasPart(report, part));
+    }
+    ASSERT_EQUAL(FindPart(report, "stop_vertices").items, 20u);
+    ASSERT_EQUAL(FindPart(report, "graph.incidence_lists").items, 40u);
+    ASSERT_EQUAL(FindPart(report, "graph.edges").items, FindPart(report, "edge_items").items);
+    //Таблица маршрутов квадратична по числу вершин
+    ASSERT_EQUAL(FindPart(report, "routes").items, 40u * 40u);
+    ASSERT(FindPart(large_router.GetMemoryUsage(), "routes").bytes > 10 * FindPart(report, "routes").bytes);
+}
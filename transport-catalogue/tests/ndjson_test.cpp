@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catalogue_version.h"
+#include "json.h"
+#include "json_network.h"
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "ndjson.h"
+#include "reference_router.h"
+#include "test_network.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Прогоняет режим NDJSON: первая строка — документ с base_requests, затем строки lines.
+//Возвращает строки ответа и справочник последней опубликованной версии
+struct NdjsonRun {
+    std::vector<std::string> responses;
+    std::shared_ptr<const CatalogueVersion> last_version;
+};
+
+NdjsonRun RunLines(const TestNetwork& network, const json::Array& stat_requests, const std::vector<std::string>& lines) {
+    const std::string document = MakeInputDocument(network.data, stat_requests);
+    json::JsonReader reader{std::string_view(document)};
+    renderer::MapRenderer renderer(reader.ParseRenderSettings());
+    reader.MakeDB();
+    CatalogueVersions versions(std::make_shared<const CatalogueVersion>(reader.ReleaseDB(), reader.ParseRoutingSettings(), std::nullopt,
+                                                                        renderer, reader.GetDocumentMemoryUsage()));
+    std::string input;
+    for (const std::string& line : lines) {
+        input += line + "\n"s;
+    }
+    std::istringstream in(input);
+    std::ostringstream out;
+    RunNdjson(in, out, reader, versions, renderer);
+
+    NdjsonRun run;
+    std::istringstream output(out.str());
+    for (std::string line; std::getline(output, line);) {
+        run.responses.push_back(line);
+    }
+    run.last_version = versions.Acquire();
+    return run;
+}
+
+std::string ToLine(const json::Node& node) {
+    std::ostringstream out;
+    out.precision(17);
+    json::Print(json::Document{node}, out, json::PrintFormat::COMPACT);
+    return out.str();
+}
+
+json::Dict ParseResponse(const std::string& line) {
+    return json::Load(line).GetRoot().AsMap();
+}
+
+json::Node StopRequest(int id, std::string_view name) {
+    return json::Dict{{"id"s, id}, {"type"s, "Stop"s}, {"name"s, std::string(name)}};
+}
+
+} // namespace
+
+TEST(NdjsonAnswersEachLine) {
+    const TestNetwork network = MakeRandomNetwork(101, 20, 4, 5);
+    const json::Array stat_requests{StopRequest(1, "Stop 1"sv), StopRequest(2, "No such stop"sv)};
+    std::vector<std::string> lines;
+    for (int id = 3; id < 23; ++id) {
+        lines.push_back(ToLine(json::Dict{{"id"s, id}, {"type"s, "Route"s}, {"from"s, "Stop 0"s},
+                                          {"to"s, "Stop "s + std::to_string(id - 3)}}));
+        //Пустые строки пропускаются
+        lines.push_back(id % 2 ? ""s : " \t"s);
+    }
+    const NdjsonRun run = RunLines(network, stat_requests, lines);
+
+    //По строке на каждый запрос документа и каждую строку с запросом, в том же порядке
+    ASSERT_EQUAL(run.responses.size(), 22u);
+    for (size_t i = 0; i < run.responses.size(); ++i) {
+        ASSERT(ParseResponse(run.responses[i]).at("request_id"sv) == json::Node(static_cast<int>(i) + 1));
+    }
+    ASSERT_EQUAL(ParseResponse(run.responses[1]).at("error_message"sv).AsString(), "not found"s);
+    const ReferenceRouter reference(run.last_version->db, routing::RoutingSettings{});
+    for (size_t i = 2; i < run.responses.size(); ++i) {
+        const json::Dict response = ParseResponse(run.responses[i]);
+        const std::optional<double> expected = reference.GetRouteTime("Stop 0"sv, "Stop "s + std::to_string(i - 2));
+        ASSERT_EQUAL(response.count("total_time"sv), expected ? 1u : 0u);
+        if (expected) {
+            ASSERT(std::abs(response.at("total_time"sv).AsDouble() - *expected) < 1e-4 * std::max(1.0, *expected));
+        }
+    }
+}
+
+TEST(NdjsonRecoversFromBadLines) {
+    const TestNetwork network = MakeRandomNetwork(102, 10, 2, 4);
+    const NdjsonRun run = RunLines(network, {}, {
+        "{\"id\": 1, \"type\": \"Stop\", \"name\": \"Stop 1\""s, //Незакрытый словарь
+        ToLine(StopRequest(2, "Stop 1"sv)),
+        ToLine(json::Dict{{"id"s, 3}, {"type"s, "Unknown"s}}),
+        ToLine(json::Dict{{"id"s, 4}, {"type"s, "Bus"s}}), //Нет имени
+        "[1, 2]"s, //Не словарь
+        ToLine(StopRequest(6, "Stop 2"sv)),
+    });
+    ASSERT_EQUAL(run.responses.size(), 6u);
+    for (size_t i : {0, 2, 3, 4}) {
+        const json::Dict response = ParseResponse(run.responses[i]);
+        ASSERT_EQUAL(response.size(), 1u);
+        ASSERT(response.at("error_message"sv).IsString());
+    }
+    ASSERT(ParseResponse(run.responses[1]).at("request_id"sv) == json::Node(2));
+    ASSERT(ParseResponse(run.responses[5]).at("request_id"sv) == json::Node(6));
+}
+
+TEST(NdjsonAppliesBaseRequestLines) {
+    const TestNetwork network = MakeRandomNetwork(103, 20, 4, 5);
+    TestNetwork delta;
+    const std::string_view added = delta.AddStop("Added", {55.75, 37.60});
+    delta.AddDistance(added, "Stop 0"sv, 800);
+    delta.AddBus("Added bus", {added, "Stop 0"sv}, false);
+    //Пакет с ошибкой: остановка уже есть; отклоняется целиком вместе с новой остановкой
+    TestNetwork rejected;
+    rejected.AddStop("Rejected", {55.7, 37.6});
+    rejected.AddStop("Stop 1", {55.7, 37.6});
+
+    const NdjsonRun run = RunLines(network, {}, {
+        ToLine(StopRequest(1, "Added"sv)),
+        ToLine(json::Dict{{"base_requests"s, MakeBaseRequests(delta.data)}}),
+        ToLine(StopRequest(2, "Added"sv)),
+        ToLine(json::Dict{{"base_requests"s, MakeBaseRequests(rejected.data)}}),
+        ToLine(StopRequest(3, "Rejected"sv)),
+        ToLine(StopRequest(4, "Stop 0"sv)),
+    });
+    //На пакеты изменений ответа нет, на отклонённый — ошибка
+    ASSERT_EQUAL(run.responses.size(), 5u);
+    ASSERT_EQUAL(ParseResponse(run.responses[0]).at("error_message"sv).AsString(), "not found"s);
+    ASSERT(ParseResponse(run.responses[1]).at("buses"sv) == json::Node(json::Array{"Added bus"s}));
+    ASSERT(ParseResponse(run.responses[2]).count("error_message"sv));
+    ASSERT(!ParseResponse(run.responses[2]).count("request_id"sv));
+    ASSERT_EQUAL(ParseResponse(run.responses[3]).at("error_message"sv).AsString(), "not found"s);
+    const json::Array buses = ParseResponse(run.responses[4]).at("buses"sv).AsArray();
+    ASSERT(std::find(buses.begin(), buses.end(), json::Node("Added bus"s)) != buses.end());
+
+    //Последняя версия — сеть вместе с принятым пакетом
+    TransportCatalogue expected;
+    expected.Load(network.data);
+    expected.Update(delta.data);
+    AssertSameCatalogue(run.last_version->db, expected);
+    AssertSameRouteTimes(run.last_version->db, run.last_version->router, ReferenceRouter(expected, routing::RoutingSettings{}));
+}
@@ -0,0 +1,103 @@
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "reference_router.h"
+#include "serialization.h"
+#include "temp_file.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+using DistanceMap = std::map<std::pair<std::string, std::string>, int>;
+
+//Все заданные расстояния; каждая пара должна встретиться при обходе один раз
+DistanceMap CollectDistances(const TransportCatalogue& db) {
+    DistanceMap result;
+    db.ForEachDistance([&result](const Distance& distance) {
+        const bool inserted = result.emplace(std::pair{std::string(distance.from), std::string(distance.to)}, distance.distance).second;
+        ASSERT(inserted);
+    });
+    return result;
+}
+
+void AssertSameDistances(const TransportCatalogue& actual, const TransportCatalogue& expected) {
+    ASSERT(CollectDistances(actual) == CollectDistances(expected));
+    //В том числе для пар без заданного расстояния и с расстоянием только в обратную сторону
+    for (const Stop* from : expected.GetStopsList()) {
+        for (const Stop* to : expected.GetStopsList()) {
+            ASSERT_EQUAL(actual.GetDistance(from->name, to->name), expected.GetDistance(from->name, to->name));
+        }
+    }
+}
+
+} // namespace
+
+TEST(MappedCatalogueMatchesLoaded) {
+    const TestNetwork network = MakeRandomNetwork(61, 80, 16, 8);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const TempFile file("mapped.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+
+    TransportCatalogue mapped;
+    serialization::MapCatalogue(file.GetPath(), mapped);
+    AssertSameCatalogue(mapped, db);
+    AssertSameDistances(mapped, db);
+    ASSERT_EQUAL(serialization::ComputeCatalogueHash(mapped), serialization::ComputeCatalogueHash(db));
+    AssertSameRouteTimes(mapped, routing::TransportRouter(mapped, routing::RoutingSettings{}), ReferenceRouter(db, routing::RoutingSettings{}));
+
+    //Сохранение читает расстояния из отображённой таблицы и даёт тот же файл
+    const TempFile again("mapped_again.bin");
+    serialization::SaveCatalogue(mapped, again.GetPath());
+    ASSERT(again.Read() == file.Read());
+}
+
+TEST(MappedCatalogueUpdateOverridesTable) {
+    const TestNetwork network = MakeRandomNetwork(62, 40, 8, 6);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const TempFile file("mapped_update.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+    TransportCatalogue mapped;
+    serialization::MapCatalogue(file.GetPath(), mapped);
+
+    TestNetwork delta;
+    const std::string_view added = delta.AddStop("Added", {55.75, 37.60});
+    delta.AddDistance(added, "Stop 3"sv, 700);
+    delta.AddBus("Added bus", {added, "Stop 3"sv, "Stop 4"sv}, false);
+    //Расстояния, уже лежащие в файле: новое значение должно заменить их и в обходе
+    for (size_t i = 0; i < network.data.distances.size(); i += 5) {
+        const Distance& distance = network.data.distances[i];
+        delta.AddDistance(distance.from, distance.to, distance.distance + 1000);
+    }
+    const CatalogueChanges mapped_changes = mapped.Update(delta.data);
+    const CatalogueChanges changes = db.Update(delta.data);
+    ASSERT_EQUAL(mapped_changes.changed_buses.size(), changes.changed_buses.size());
+    AssertSameCatalogue(mapped, db);
+    AssertSameDistances(mapped, db);
+    ASSERT_EQUAL(serialization::ComputeCatalogueHash(mapped), serialization::ComputeCatalogueHash(db));
+}
+
+TEST(MappedCatalogueOutlivesFileRemoval) {
+    const TestNetwork network = MakeRandomNetwork(63, 20, 4, 4);
+    TransportCatalogue db;
+    db.Load(network.data);
+    TransportCatalogue mapped;
+    {
+        const TempFile file("mapped_removed.bin");
+        serialization::SaveCatalogue(db, file.GetPath());
+        serialization::MapCatalogue(file.GetPath(), mapped);
+    }
+    AssertSameCatalogue(mapped, db);
+    AssertSameDistances(mapped, db);
+    //Копия разделяет отображение с оригиналом
+    const TransportCatalogue copy(mapped);
+    AssertSameDistances(copy, db);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "json.h"
+
+//Символы строк: обычные, экранируемые при выводе и многобайтовые UTF-8
+constexpr std::string_view RANDOM_JSON_PIECES[] = {
+    "a", "Z", "0", " ", "/", "\"", "\\", "\n", "\r", "\t", "я", "Ё", "\x7f", "{", ",",
+};
+
+//Строка длиной до max_size кусков: длинные пересекают границы блоков при поиске особых символов
+inline std::string MakeRandomJsonString(std::mt19937& generator, size_t max_size) {
+    std::string result;
+    const size_t size = generator() % (max_size + 1);
+    //Чаще всего обычные символы идут длинными отрезками
+    const bool plain = generator() % 2 == 0;
+    for (size_t i = 0; i < size; ++i) {
+        result += RANDOM_JSON_PIECES[generator() % (plain ? 5 : std::size(RANDOM_JSON_PIECES))];
+    }
+    return result;
+}
+
+/*
+ * Случайное значение JSON глубиной до depth. Дробные числа не целые и не длиннее
+ * 6 значащих цифр: Print выводит их без потерь, и разбор возвращает тот же узел
+ */
+inline json::Node MakeRandomJson(std::mt19937& generator, int depth) {
+    switch (generator() % (depth > 0 ? 8 : 6)) {
+        case 0:
+            return nullptr;
+        case 1:
+            return generator() % 2 == 0;
+        case 2:
+            return static_cast<int>(generator()) / (1 << (generator() % 31));
+        case 3:
+            return (static_cast<int>(generator() % 4000) - 2000 + 0.5) / 4;
+        case 4:
+        case 5:
+            return MakeRandomJsonString(generator, 80);
+        case 6: {
+            json::Array array;
+            for (size_t i = generator() % 6; i > 0; --i) {
+                array.push_back(MakeRandomJson(generator, depth - 1));
+            }
+            return array;
+        }
+        default: {
+            json::Dict dict;
+            for (size_t i = generator() % 6; i > 0; --i) {
+                dict.emplace(MakeRandomJsonString(generator, 10), MakeRandomJson(generator, depth - 1));
+            }
+            return dict;
+        }
+    }
+}
+
+inline std::string PrintJson(const json::Node& node, json::PrintFormat format = json::PrintFormat::PRETTY) {
+    std::ostringstream out;
+    json::Print(json::Document{node}, out, format);
+    return out.str();
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "geo.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+/*
+ * Эталон для проверки TransportRouter: тот же граф (у каждой остановки вершины начала
+ * и конца ожидания, рёбра автобусов между любыми двумя остановками маршрута, пешие
+ * пересадки между началами ожидания), построенный напрямую и решённый Флойдом — Уоршеллом.
+ * Профили и пересадки берутся из настроек, соседи для пересадок ищутся перебором всех пар.
+ */
+class ReferenceRouter {
+public:
+    ReferenceRouter(const TransportCatalogue& db, const routing::RoutingSettings& settings) {
+        const auto& stops = db.GetStopsList();
+        for (const Stop* stop : stops) {
+            stop_ids_.emplace(stop->name, stop_ids_.size());
+        }
+        vertex_count_ = stop_ids_.size() * 2;
+        times_.assign(vertex_count_ * vertex_count_, INFINITY_TIME);
+        for (size_t v = 0; v < vertex_count_; ++v) {
+            At(v, v) = 0;
+        }
+        for (const Stop* stop : stops) {
+            const auto it = settings.stop_wait_times.find(stop->name);
+            const double wait_time = it != settings.stop_wait_times.end() ? it->second : settings.bus_wait_time;
+            AddEdge(Begin(stop->name), End(stop->name), wait_time);
+        }
+        for (const auto& [name, bus] : db.GetBuses()) {
+            const auto it = settings.bus_velocities.find(name);
+            const double velocity = it != settings.bus_velocities.end() ? it->second : settings.bus_velocity;
+            for (size_t i = 0; i < bus->stops.size(); ++i) {
+                int distance = 0;
+                for (size_t j = i + 1; j < bus->stops.size(); ++j) {
+                    distance += db.GetDistance(bus->stops[j - 1], bus->stops[j]);
+                    AddEdge(End(bus->stops[i]), Begin(bus->stops[j]), distance * 60.0 / (velocity * 1000));
+                }
+            }
+        }
+        if (settings.walk_transfer_distance > 0) {
+            for (const Stop* from : stops) {
+                for (const Stop* to : stops) {
+                    const double distance = geo::ComputeDistance(from->position, to->position);
+                    if (from != to && distance <= settings.walk_transfer_distance) {
+                        AddEdge(Begin(from->name), Begin(to->name), distance / (settings.walk_velocity * 1000 / 60.0));
+                    }
+                }
+            }
+        }
+        for (size_t k = 0; k < vertex_count_; ++k) {
+            for (size_t i = 0; i < vertex_count_; ++i) {
+                for (size_t j = 0; j < vertex_count_; ++j) {
+                    At(i, j) = std::min(At(i, j), At(i, k) + At(k, j));
+                }
+            }
+        }
+    }
+
+    //Как TransportRouter::GetRouteTime: от начала ожидания на from до начала ожидания на to
+    std::optional<double> GetRouteTime(std::string_view from, std::string_view to) const {
+        const double time = times_[Begin(from) * vertex_count_ + Begin(to)];
+        if (time == INFINITY_TIME) {
+            return std::nullopt;
+        }
+        return time;
+    }
+
+private:
+    static constexpr double INFINITY_TIME = std::numeric_limits<double>::infinity();
+
+    std::unordered_map<std::string_view, size_t> stop_ids_;
+    size_t vertex_count_ = 0;
+    std::vector<double> times_;
+
+    size_t Begin(std::string_view stop) const {
+        return stop_ids_.at(stop) * 2;
+    }
+
+    size_t End(std::string_view stop) const {
+        return stop_ids_.at(stop) * 2 + 1;
+    }
+
+    double& At(size_t from, size_t to) {
+        return times_[from * vertex_count_ + to];
+    }
+
+    void AddEdge(size_t from, size_t to, double time) {
+        At(from, to) = std::min(At(from, to), time);
+    }
+};
+
+//Времена всех маршрутов совпадают с эталоном с точностью до порядка суммирования весов
+inline void AssertSameRouteTimes(const TransportCatalogue& db, const routing::TransportRouter& router,
+                                 const ReferenceRouter& reference) {
+    for (const Stop* from : db.GetStopsList()) {
+        for (const Stop* to : db.GetStopsList()) {
+            const std::optional<double> actual = router.GetRouteTime(from->name, to->name);
+            const std::optional<double> expected = reference.GetRouteTime(from->name, to->name);
+            ASSERT_EQUAL(actual.has_value(), expected.has_value());
+            if (expected) {
+                ASSERT(std::abs(*actual - *expected) <= 1e-9 * std::max(1.0, *expected));
+                ASSERT_EQUAL(router.BuildRoute(from->name, to->name).first, *actual);
+            }
+        }
+    }
+}
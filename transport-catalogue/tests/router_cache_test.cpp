@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "reference_router.h"
+#include "temp_file.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Раскладка файла-кэша версии 1 (см. transport_router.cpp)
+constexpr size_t CACHE_HEADER_SIZE = 40;
+constexpr size_t CACHE_ENTRY_SIZE = 16;
+
+//Таблица маршрутов отображена из файла, а не посчитана в памяти
+bool UsesMappedTable(const routing::TransportRouter& router) {
+    for (const auto& [name, usage] : router.GetMemoryUsage().parts) {
+        if (name == "routes"s) {
+            return usage.bytes == 0;
+        }
+    }
+    return false;
+}
+
+//Ячейка таблицы from→to с заданным prev_edge
+std::string SetPrevEdge(std::string bytes, size_t vertex_count, size_t from, size_t to, uint64_t prev_edge) {
+    const size_t offset = CACHE_HEADER_SIZE + (from * vertex_count + to) * CACHE_ENTRY_SIZE + sizeof(double);
+    std::memcpy(bytes.data() + offset, &prev_edge, sizeof(prev_edge));
+    return bytes;
+}
+
+} // namespace
+
+TEST(RouterCacheIsReusedForSameContent) {
+    const TestNetwork network = MakeRandomNetwork(41, 40, 8, 5);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const routing::RoutingSettings settings;
+    const TempFile cache("routes.cache");
+
+    const routing::TransportRouter computed(db, settings, cache.GetPath());
+    ASSERT(!UsesMappedTable(computed));
+    const std::string saved = cache.Read();
+    ASSERT_EQUAL(saved.size(), CACHE_HEADER_SIZE + 80 * 80 * CACHE_ENTRY_SIZE);
+
+    //Тот же справочник, загруженный заново
+    TransportCatalogue same;
+    same.Load(network.data);
+    const routing::TransportRouter mapped(same, settings, cache.GetPath());
+    ASSERT(UsesMappedTable(mapped));
+    ASSERT(cache.Read() == saved);
+    const ReferenceRouter reference(same, settings);
+    AssertSameRouteTimes(same, mapped, reference);
+    //Маршруты из файла те же, что посчитанные в памяти
+    for (const Stop* from : same.GetStopsList()) {
+        for (const Stop* to : same.GetStopsList()) {
+            const auto [mapped_time, mapped_items] = mapped.BuildRoute(from->name, to->name);
+            const auto [computed_time, computed_items] = computed.BuildRoute(from->name, to->name);
+            ASSERT_EQUAL(mapped_time, computed_time);
+            ASSERT_EQUAL(mapped_items.size(), computed_items.size());
+        }
+    }
+}
+
+TEST(RouterCacheIsRejectedWhenContentChanges) {
+    const TestNetwork network = MakeRandomNetwork(42, 30, 6, 5);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const routing::RoutingSettings settings;
+    const TempFile cache("changed.cache");
+    { const routing::TransportRouter router(db, settings, cache.GetPath()); }
+    const std::string saved = cache.Read();
+
+    //Одно расстояние длиннее: число вершин и рёбер то же, отличается только хэш содержимого
+    TestNetwork changed = MakeRandomNetwork(42, 30, 6, 5);
+    changed.data.distances.back().distance += 5000;
+    TransportCatalogue changed_db;
+    changed_db.Load(changed.data);
+    const routing::TransportRouter router(changed_db, settings, cache.GetPath());
+    ASSERT(!UsesMappedTable(router));
+    AssertSameRouteTimes(changed_db, router, ReferenceRouter(changed_db, settings));
+    //Файл перезаписан под новое содержимое
+    ASSERT(cache.Read() != saved);
+    ASSERT(UsesMappedTable(routing::TransportRouter(changed_db, settings, cache.GetPath())));
+}
+
+TEST(RouterCacheIsRejectedWhenSettingsChange) {
+    const TestNetwork network = MakeRandomNetwork(43, 30, 6, 5);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const TempFile cache("settings.cache");
+    routing::RoutingSettings settings;
+    { const routing::TransportRouter router(db, settings, cache.GetPath()); }
+
+    settings.stop_wait_times.emplace("Stop 3", 1.5);
+    const routing::TransportRouter router(db, settings, cache.GetPath());
+    ASSERT(!UsesMappedTable(router));
+    AssertSameRouteTimes(db, router, ReferenceRouter(db, settings));
+}
+
+TEST(RouterCacheIsRebuiltWhenDamaged) {
+    const TestNetwork network = MakeRandomNetwork(44, 20, 4, 5);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const routing::RoutingSettings settings;
+    const TempFile cache("damaged.cache");
+    { const routing::TransportRouter router(db, settings, cache.GetPath()); }
+    const std::string saved = cache.Read();
+
+    for (const std::string& damaged : {saved.substr(0, saved.size() - 1), "X"s + saved.substr(1), saved.substr(0, 10), ""s}) {
+        cache.Write(damaged);
+        const routing::TransportRouter router(db, settings, cache.GetPath());
+        ASSERT(!UsesMappedTable(router));
+        ASSERT(cache.Read() == saved);
+    }
+}
+
+TEST(RouterWorksWhenCacheCannotBeSaved) {
+    const TestNetwork network = MakeRandomNetwork(45, 20, 4, 5);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const routing::RoutingSettings settings;
+    const routing::TransportRouter router(db, settings, "/nonexistent-directory/routes.cache");
+    AssertSameRouteTimes(db, router, ReferenceRouter(db, settings));
+}
+
+TEST(CorruptedRouterCacheEntriesThrow) {
+    const TestNetwork network = MakeRandomNetwork(46, 20, 4, 5);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const routing::RoutingSettings settings;
+    const TempFile cache("entries.cache");
+    { const routing::TransportRouter router(db, settings, cache.GetPath()); }
+    const std::string saved = cache.Read();
+    const size_t vertex_count = db.GetStopsList().size() * 2;
+    //Остановки нумеруются в порядке обхода: у i-й вершины 2i и 2i + 1, ребро ожидания — i-е
+    const std::string_view first = db.GetStopsList()[0]->name;
+    const std::string_view third = db.GetStopsList()[2]->name;
+
+    //Несуществующее ребро
+    cache.Write(SetPrevEdge(saved, vertex_count, 0, 4, 1'000'000));
+    {
+        const routing::TransportRouter router(db, settings, cache.GetPath());
+        ASSERT(UsesMappedTable(router));
+        ASSERT_THROWS(router.BuildRoute(first, third), std::runtime_error);
+    }
+    //Ребро ожидания на самой остановке назначения замыкает цепочку на себя
+    cache.Write(SetPrevEdge(saved, vertex_count, 0, 4, 2));
+    {
+        const routing::TransportRouter router(db, settings, cache.GetPath());
+        ASSERT(UsesMappedTable(router));
+        ASSERT_THROWS(router.BuildRoute(first, third), std::runtime_error);
+        //Остальные ячейки исправны
+        ASSERT_EQUAL(router.BuildRoute(first, first).first, 0.0);
+    }
+}
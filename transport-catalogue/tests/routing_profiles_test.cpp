@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "json_reader.h"
+#include "reference_router.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Профили для части маршрутов и остановок сети и для имён, которых в ней нет
+routing::RoutingSettings MakeRandomProfiles(const TestNetwork& network, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> velocity(10, 90);
+    std::uniform_real_distribution<double> wait_time(0, 15);
+    routing::RoutingSettings settings;
+    for (const Bus& bus : network.data.buses) {
+        if (generator() % 2 == 0) {
+            settings.bus_velocities.emplace(bus.name, velocity(generator));
+        }
+    }
+    for (const Stop& stop : network.data.stops) {
+        if (generator() % 2 == 0) {
+            settings.stop_wait_times.emplace(stop.name, wait_time(generator));
+        }
+    }
+    settings.bus_velocities.emplace("No such bus", 1);
+    settings.stop_wait_times.emplace("No such stop", 1000);
+    return settings;
+}
+
+//Время каждого участка маршрута считается по профилю его остановки или автобуса
+void AssertItemsUseProfiles(const TransportCatalogue& db, const routing::TransportRouter& router, const routing::RoutingSettings& settings) {
+    const auto buses = db.GetBuses();
+    for (const Stop* from : db.GetStopsList()) {
+        for (const Stop* to : db.GetStopsList()) {
+            std::string_view position = from->name;
+            for (const routing::RouteItem& item : router.BuildRoute(from->name, to->name).second) {
+                if (const auto* wait = std::get_if<routing::StopEdge>(&item)) {
+                    const auto it = settings.stop_wait_times.find(wait->stop_name);
+                    ASSERT_EQUAL(wait->time, it != settings.stop_wait_times.end() ? it->second : settings.bus_wait_time);
+                    position = wait->stop_name;
+                    continue;
+                }
+                const auto& ride = std::get<routing::BusEdge>(item);
+                const auto it = settings.bus_velocities.find(ride.bus);
+                const double velocity = it != settings.bus_velocities.end() ? it->second : settings.bus_velocity;
+                //Остановка может встречаться в маршруте несколько раз: подходит любая поездка оттуда
+                const Bus* bus = buses.at(ride.bus);
+                bool matched = false;
+                for (size_t i = 0; i + ride.span_count < bus->stops.size() && !matched; ++i) {
+                    if (bus->stops[i] != position) {
+                        continue;
+                    }
+                    int distance = 0;
+                    for (size_t j = i + 1; j <= i + ride.span_count; ++j) {
+                        distance += db.GetDistance(bus->stops[j - 1], bus->stops[j]);
+                    }
+                    matched = std::abs(ride.time - distance * 60.0 / (velocity * 1000)) < 1e-9 * std::max(1.0, ride.time);
+                }
+                ASSERT(matched);
+                position = {};
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(RoutingProfilesMatchReference) {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        const TestNetwork network = MakeRandomNetwork(seed + 70, 40, 10, 6);
+        TransportCatalogue db;
+        db.Load(network.data);
+        const routing::RoutingSettings settings = MakeRandomProfiles(network, seed);
+        const routing::TransportRouter router(db, settings);
+        AssertSameRouteTimes(db, router, ReferenceRouter(db, settings));
+        AssertItemsUseProfiles(db, router, settings);
+    }
+}
+
+TEST(RoutingProfilesChooseFasterBus) {
+    TestNetwork network;
+    const std::string_view a = network.AddStop("A", {55.70, 37.60});
+    const std::string_view b = network.AddStop("B", {55.71, 37.60});
+    const std::string_view c = network.AddStop("C", {55.72, 37.60});
+    network.AddDistance(a, b, 6000);
+    network.AddDistance(b, c, 6000);
+    network.AddDistance(a, c, 6000);
+    network.AddBus("local", {a, c}, false);
+    network.AddBus("express", {a, c}, false);
+    network.AddBus("feeder", {a, b}, false);
+    network.AddBus("shuttle", {b, c}, false);
+    TransportCatalogue db;
+    db.Load(network.data);
+
+    routing::RoutingSettings settings;
+    settings.bus_velocity = 20;
+    settings.bus_velocities.emplace("express", 60);
+    const routing::TransportRouter router(db, settings);
+    const auto [time, items] = router.BuildRoute(a, c);
+    //6 минут ожидания и 6 км со скоростью 60 км/ч
+    ASSERT_EQUAL(time, 12.0);
+    ASSERT_EQUAL(items.size(), 2u);
+    ASSERT_EQUAL(std::get<routing::BusEdge>(items[1]).bus, "express"sv);
+
+    //Пересадка через B дешевле прямой поездки, если ожидание на B нулевое и оба участка быстрые
+    settings.bus_velocities = {{"feeder", 120}, {"shuttle", 120}};
+    settings.stop_wait_times = {{"B", 0}};
+    const routing::TransportRouter transfer_router(db, settings);
+    const auto [transfer_time, transfer_items] = transfer_router.BuildRoute(a, c);
+    ASSERT_EQUAL(transfer_time, 6.0 + 3.0 + 0.0 + 3.0);
+    ASSERT_EQUAL(transfer_items.size(), 4u);
+    ASSERT_EQUAL(std::get<routing::StopEdge>(transfer_items[2]).stop_name, "B"sv);
+    ASSERT_EQUAL(std::get<routing::StopEdge>(transfer_items[2]).time, 0.0);
+}
+
+TEST(RoutingProfilesApplyToUpdatedCatalogue) {
+    const TestNetwork base = MakeRandomNetwork(74, 30, 6, 5);
+    TransportCatalogue db;
+    db.Load(base.data);
+    //Профили заданы и для остановки и маршрута, которые появятся только в пакете изменений
+    routing::RoutingSettings settings = MakeRandomProfiles(base, 75);
+    settings.bus_velocities.emplace("Later bus", 15);
+    settings.stop_wait_times.emplace("Later", 0.5);
+    routing::TransportRouter router(db, settings);
+
+    TestNetwork delta;
+    const std::string_view later = delta.AddStop("Later", {55.75, 37.60});
+    delta.AddDistance(later, "Stop 0"sv, 1500);
+    delta.AddDistance("Stop 0"sv, "Stop 1"sv, 2500);
+    delta.AddBus("Later bus", {later, "Stop 0"sv, "Stop 1"sv}, false);
+    router.Update(db.Update(delta.data));
+    AssertSameRouteTimes(db, router, ReferenceRouter(db, settings));
+    AssertItemsUseProfiles(db, router, settings);
+}
+
+TEST(RoutingProfilesAreParsed) {
+    const std::string document = R"({"base_requests": [], "routing_settings": {"bus_wait_time": 2, "bus_velocity": 30,
+        "bus_velocities": {"14": 55.5, "Express": 80}, "stop_wait_times": {"Hub": 7.5, "Kerb": 0}}})"s;
+    const routing::RoutingSettings settings = json::JsonReader(document).ParseRoutingSettings();
+    ASSERT_EQUAL(settings.bus_velocities.size(), 2u);
+    ASSERT_EQUAL(settings.bus_velocities.at("14"), 55.5);
+    ASSERT_EQUAL(settings.bus_velocities.at("Express"), 80.0);
+    ASSERT_EQUAL(settings.stop_wait_times.size(), 2u);
+    ASSERT_EQUAL(settings.stop_wait_times.at("Hub"), 7.5);
+    ASSERT_EQUAL(settings.stop_wait_times.at("Kerb"), 0.0);
+    //Без профилей — только общие значения
+    const std::string plain = R"({"base_requests": [], "routing_settings": {"bus_wait_time": 2, "bus_velocity": 30}})"s;
+    const routing::RoutingSettings plain_settings = json::JsonReader(plain).ParseRoutingSettings();
+    ASSERT(plain_settings.bus_velocities.empty());
+    ASSERT(plain_settings.stop_wait_times.empty());
+}
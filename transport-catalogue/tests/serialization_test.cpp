@@ -0,0 +1,215 @@
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "serialization.h"
+#include "temp_file.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Смещения полей формата версии 1 (см. serialization.cpp)
+constexpr size_t HEADER_SIZE = 56;
+constexpr size_t STOP_RECORD_SIZE = 32;
+constexpr size_t DISTANCE_RECORD_SIZE = 8;
+constexpr size_t BUS_RECORD_SIZE = 32;
+
+template <typename T>
+T Get(const std::string& bytes, size_t offset) {
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+std::string Put(std::string bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    return bytes;
+}
+
+struct Sections {
+    uint64_t stops_count;
+    size_t stops;
+    size_t distances;
+    size_t buses;
+    size_t bus_stops;
+};
+
+Sections GetSections(const std::string& bytes) {
+    Sections sections{};
+    sections.stops_count = Get<uint64_t>(bytes, 16);
+    sections.stops = HEADER_SIZE;
+    sections.distances = sections.stops + sections.stops_count * STOP_RECORD_SIZE;
+    sections.buses = sections.distances + Get<uint64_t>(bytes, 24) * DISTANCE_RECORD_SIZE;
+    sections.bus_stops = sections.buses + Get<uint64_t>(bytes, 32) * BUS_RECORD_SIZE;
+    return sections;
+}
+
+TransportCatalogue LoadFrom(const TempFile& file) {
+    TransportCatalogue db;
+    serialization::LoadCatalogue(file.GetPath(), db);
+    return db;
+}
+
+//Испорченные копии файла: каждая должна отклоняться с FormatError
+std::vector<std::pair<std::string, std::string>> MakeCorruptedFiles(const std::string& bytes) {
+    const Sections sections = GetSections(bytes);
+    const uint64_t max = UINT64_MAX;
+    return {
+        {"magic", Put(bytes, 0, 'X')},
+        {"version", Put<uint32_t>(bytes, 8, 2)},
+        {"trailing byte", bytes + '\0'},
+        {"stops count product overflow", Put<uint64_t>(bytes, 16, uint64_t{1} << 59)},
+        {"distances count product overflow", Put<uint64_t>(bytes, 24, max / DISTANCE_RECORD_SIZE + 1)},
+        {"bus stops count", Put<uint64_t>(bytes, 40, max)},
+        {"names size", Put<uint64_t>(bytes, 48, max - 3)},
+        {"name offset", Put<uint64_t>(bytes, sections.stops, max)},
+        {"name size", Put<uint32_t>(bytes, sections.stops + 8, UINT32_MAX)},
+        {"distances of a stop", Put<uint32_t>(bytes, sections.stops + 12, UINT32_MAX)},
+        {"bus stops begin", Put<uint64_t>(bytes, sections.buses + 16, max)},
+        {"bus stops count", Put<uint64_t>(bytes, sections.buses + 24, max - 1)},
+        {"bus stop id", Put<uint32_t>(bytes, sections.bus_stops, static_cast<uint32_t>(sections.stops_count))},
+    };
+}
+
+} // namespace
+
+TEST(CatalogueFileRoundTrip) {
+    const TestNetwork network = MakeRandomNetwork(31, 200, 40, 10);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const TempFile file("round_trip.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+
+    const TransportCatalogue loaded = LoadFrom(file);
+    AssertSameCatalogue(loaded, db);
+    ASSERT_EQUAL(serialization::ComputeCatalogueHash(loaded), serialization::ComputeCatalogueHash(db));
+    size_t distances_count = 0;
+    loaded.ForEachDistance([&db, &distances_count](const Distance& distance) {
+        ASSERT_EQUAL(distance.distance, db.GetDistance(distance.from, distance.to));
+        ++distances_count;
+    });
+    //Повторно заданное расстояние заменяет прежнее
+    std::set<std::pair<std::string_view, std::string_view>> pairs;
+    for (const Distance& distance : network.data.distances) {
+        pairs.emplace(distance.from, distance.to);
+    }
+    ASSERT_EQUAL(distances_count, pairs.size());
+
+    //Повторное сохранение загруженного справочника даёт тот же файл
+    const TempFile again("round_trip_again.bin");
+    serialization::SaveCatalogue(loaded, again.GetPath());
+    ASSERT(again.Read() == file.Read());
+}
+
+TEST(CatalogueFileKeepsDeltaUpdates) {
+    const TestNetwork network = MakeRandomNetwork(32, 50, 10, 6);
+    TransportCatalogue db;
+    db.Load(network.data);
+    TestNetwork delta;
+    const std::string_view stop = delta.AddStop("Added", {55.7, 37.6});
+    delta.AddDistance(stop, "Stop 0"sv, 900);
+    delta.AddBus("Added bus", {stop, "Stop 0"sv, "Stop 1"sv}, false);
+    db.Update(delta.data);
+
+    const TempFile file("delta.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+    AssertSameCatalogue(LoadFrom(file), db);
+}
+
+TEST(CatalogueFileOfEmptyCatalogue) {
+    const TransportCatalogue db;
+    const TempFile file("empty.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+    const TransportCatalogue loaded = LoadFrom(file);
+    ASSERT(loaded.GetStopsList().empty());
+    ASSERT(loaded.GetBuses().empty());
+}
+
+TEST(LoadedCatalogueOutlivesFileRemoval) {
+    const TestNetwork network = MakeRandomNetwork(33, 20, 4, 4);
+    TransportCatalogue db;
+    db.Load(network.data);
+    TransportCatalogue loaded;
+    {
+        const TempFile file("removed.bin");
+        serialization::SaveCatalogue(db, file.GetPath());
+        serialization::LoadCatalogue(file.GetPath(), loaded);
+    }
+    //Отображение живёт, пока его держит справочник
+    AssertSameCatalogue(loaded, db);
+}
+
+TEST(CatalogueFileRejectsCorruption) {
+    const TestNetwork network = MakeRandomNetwork(34, 10, 3, 4);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const TempFile file("valid.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+    const std::string bytes = file.Read();
+
+    const TempFile corrupted("corrupted.bin");
+    for (const auto& [name, content] : MakeCorruptedFiles(bytes)) {
+        corrupted.Write(content);
+        for (const auto load : {serialization::LoadCatalogue, serialization::MapCatalogue}) {
+            TransportCatalogue target;
+            bool rejected = false;
+            try {
+                load(corrupted.GetPath(), target);
+            } catch (const serialization::FormatError&) {
+                rejected = true;
+            }
+            ASSERT_EQUAL(name + (rejected ? " rejected" : " accepted"), name + " rejected");
+        }
+    }
+    //Любой обрезанный файл, включая пустой
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        corrupted.Write(bytes.substr(0, size));
+        TransportCatalogue target;
+        ASSERT_THROWS(serialization::LoadCatalogue(corrupted.GetPath(), target), serialization::FormatError);
+    }
+}
+
+TEST(CatalogueFileRejectsUnknownStopInDistances) {
+    const TestNetwork network = MakeRandomNetwork(35, 10, 3, 4);
+    TransportCatalogue db;
+    db.Load(network.data);
+    const TempFile file("distances.bin");
+    serialization::SaveCatalogue(db, file.GetPath());
+    const std::string bytes = file.Read();
+    const Sections sections = GetSections(bytes);
+    file.Write(Put<uint32_t>(bytes, sections.distances, static_cast<uint32_t>(sections.stops_count)));
+    TransportCatalogue target;
+    ASSERT_THROWS(serialization::LoadCatalogue(file.GetPath(), target), serialization::FormatError);
+}
+
+TEST(CatalogueHashTracksContent) {
+    const TestNetwork network = MakeRandomNetwork(36, 20, 4, 4);
+    TransportCatalogue db;
+    db.Load(network.data);
+    TransportCatalogue same;
+    same.Load(network.data);
+    ASSERT_EQUAL(serialization::ComputeCatalogueHash(db), serialization::ComputeCatalogueHash(same));
+
+    TestNetwork changed_distance = MakeRandomNetwork(36, 20, 4, 4);
+    //Последнее заданное расстояние ничем не переопределяется
+    changed_distance.data.distances.back().distance += 1;
+    TransportCatalogue other;
+    other.Load(changed_distance.data);
+    ASSERT(serialization::ComputeCatalogueHash(other) != serialization::ComputeCatalogueHash(db));
+
+    TestNetwork moved_stop = MakeRandomNetwork(36, 20, 4, 4);
+    moved_stop.data.stops.back().coordinates.lat += 1e-9;
+    TransportCatalogue moved;
+    moved.Load(moved_stop.data);
+    ASSERT(serialization::ComputeCatalogueHash(moved) != serialization::ComputeCatalogueHash(db));
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "reference_router.h"
+#include "sharded_router.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Регионы с общими пограничными остановками и та же сеть одним справочником
+struct Regions {
+    std::deque<TestNetwork> networks;
+    std::deque<TransportCatalogue> dbs;
+    std::vector<std::vector<std::string_view>> boundaries;
+    TestNetwork whole;
+    TransportCatalogue whole_db;
+
+    std::vector<routing::Shard> MakeShards() const {
+        std::vector<routing::Shard> shards;
+        for (size_t i = 0; i < dbs.size(); ++i) {
+            shards.push_back({networks[i].names.front(), dbs[i], boundaries[i]});
+        }
+        return shards;
+    }
+};
+
+//Расстояние зависит только от пары остановок и симметрично: одинаково во всех регионах
+//и в объединённой сети, в том числе при подстановке обратного направления.
+//Формула через точки на сфере даёт 0, а не NaN, для совпадающих остановок
+int MakeDistance(const Stop& from, const Stop& to) {
+    const size_t hash = std::hash<std::string_view>{}(from.name) ^ std::hash<std::string_view>{}(to.name);
+    return static_cast<int>(std::ceil(geo::ComputeDistance(geo::ToSpherePoint(from.coordinates), geo::ToSpherePoint(to.coordinates)) * (1.0 + hash % 50 / 100.0)));
+}
+
+void BuildRegions(Regions& regions, unsigned seed, size_t regions_count, size_t gates_count) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> lat(55.60, 55.90);
+    std::uniform_real_distribution<double> lng(37.40, 37.80);
+    std::vector<Stop> gates;
+    for (size_t i = 0; i < gates_count; ++i) {
+        const std::string_view name = regions.whole.AddStop("Gate " + std::to_string(i), {lat(generator), lng(generator)});
+        gates.push_back(regions.whole.data.stops.back());
+        gates.back().name = name;
+    }
+    for (size_t region = 0; region < regions_count; ++region) {
+        TestNetwork& network = regions.networks.emplace_back();
+        network.AddName("Region " + std::to_string(region));
+        std::vector<Stop> stops;
+        //Регион связан с 2 из пограничных остановок: с соседями по кругу
+        std::vector<std::string_view>& boundary = regions.boundaries.emplace_back();
+        for (size_t gate : {region % gates_count, (region + 1) % gates_count}) {
+            stops.push_back(gates[gate]);
+            network.data.stops.push_back(gates[gate]);
+            boundary.push_back(gates[gate].name);
+        }
+        for (size_t i = 0; i < 15; ++i) {
+            const geo::Coordinates coordinates{lat(generator), lng(generator)};
+            const std::string name = "R" + std::to_string(region) + " stop " + std::to_string(i);
+            network.AddStop(name, coordinates);
+            stops.push_back(network.data.stops.back());
+            regions.whole.AddStop(name, coordinates);
+        }
+        for (size_t bus = 0; bus < 4; ++bus) {
+            std::vector<std::string_view> route;
+            std::vector<const Stop*> route_stops;
+            for (size_t i = 0; i < 5; ++i) {
+                const Stop& stop = stops[generator() % stops.size()];
+                route.push_back(stop.name);
+                route_stops.push_back(&stop);
+            }
+            for (size_t i = 1; i < route_stops.size(); ++i) {
+                const int distance = MakeDistance(*route_stops[i - 1], *route_stops[i]);
+                network.AddDistance(route[i - 1], route[i], distance);
+                regions.whole.AddDistance(route[i - 1], route[i], distance);
+            }
+            const std::string name = "R" + std::to_string(region) + " bus " + std::to_string(bus);
+            network.AddBus(name, route, false);
+            regions.whole.AddBus(name, route, false);
+        }
+        regions.dbs.emplace_back().Load(network.data);
+    }
+    regions.whole_db.Load(regions.whole.data);
+}
+
+} // namespace
+
+TEST(ShardedRouterMatchesWholeNetwork) {
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Regions regions;
+        BuildRegions(regions, seed, 4, 4);
+        const routing::RoutingSettings settings;
+        const routing::ShardedRouter router(regions.MakeShards(), settings);
+        const ReferenceRouter reference(regions.whole_db, settings);
+        for (const Stop* from : regions.whole_db.GetStopsList()) {
+            for (const Stop* to : regions.whole_db.GetStopsList()) {
+                const auto [time, items] = router.BuildRoute(from->name, to->name);
+                const std::optional<double> expected = reference.GetRouteTime(from->name, to->name);
+                ASSERT_EQUAL(time >= 0, expected.has_value());
+                if (!expected) {
+                    continue;
+                }
+                ASSERT(std::abs(time - *expected) < 1e-9 * std::max(1.0, *expected));
+                //Маршрут — цепочка: ожидание на остановке, где находимся, затем поездка на span_count
+                //остановок. Маршрут может проходить остановку несколько раз, поэтому держим все
+                //остановки, где поездка могла закончиться
+                double items_time = 0;
+                std::set<std::string_view> positions = {from->name};
+                for (const routing::RouteItem& item : items) {
+                    if (const auto* wait = std::get_if<routing::StopEdge>(&item)) {
+                        ASSERT(positions.count(wait->stop_name));
+                        positions = {wait->stop_name};
+                        items_time += wait->time;
+                        continue;
+                    }
+                    const auto& ride = std::get<routing::BusEdge>(item);
+                    const Bus* bus = regions.whole_db.GetBuses().at(ride.bus);
+                    std::set<std::string_view> next;
+                    for (size_t i = 0; i + ride.span_count < bus->stops.size(); ++i) {
+                        if (positions.count(bus->stops[i])) {
+                            next.insert(bus->stops[i + ride.span_count]);
+                        }
+                    }
+                    positions = std::move(next);
+                    items_time += ride.time;
+                }
+                ASSERT(positions.count(to->name));
+                ASSERT(std::abs(items_time - time) < 1e-9 * std::max(1.0, time));
+            }
+        }
+    }
+}
+
+TEST(ShardedRouterHandlesUnknownStops) {
+    Regions regions;
+    BuildRegions(regions, 4, 2, 2);
+    const routing::ShardedRouter router(regions.MakeShards(), routing::RoutingSettings{});
+    ASSERT_EQUAL(router.BuildRoute("Nowhere"sv, "Gate 0"sv).first, -1.0);
+    ASSERT_EQUAL(router.BuildRoute("Gate 0"sv, "Nowhere"sv).first, -1.0);
+    const auto [time, items] = router.BuildRoute("Gate 1"sv, "Gate 1"sv);
+    ASSERT_EQUAL(time, 0.0);
+    ASSERT(items.empty());
+}
+
+TEST(ShardedRouterRejectsUndeclaredSharedStops) {
+    Regions regions;
+    BuildRegions(regions, 5, 2, 2);
+    std::vector<routing::Shard> shards = regions.MakeShards();
+    //Остановка есть в обоих регионах, но в первом не объявлена пограничной
+    shards[0].boundary_stops.pop_back();
+    ASSERT_THROWS(routing::ShardedRouter(shards, routing::RoutingSettings{}), std::invalid_argument);
+    //Пограничная остановка, которой нет в регионе
+    shards = regions.MakeShards();
+    shards[0].boundary_stops.push_back("R1 stop 0"sv);
+    ASSERT_THROWS(routing::ShardedRouter(shards, routing::RoutingSettings{}), std::invalid_argument);
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "spatial_index.h"
+#include "testing.h"
+
+namespace {
+
+struct Stops {
+    std::deque<std::string> names;
+    std::deque<Stop> stops;
+
+    const Stop* Add(std::string name, geo::Coordinates coordinates) {
+        return &stops.emplace_back(Stop{names.emplace_back(std::move(name)), coordinates, geo::ToSpherePoint(coordinates)});
+    }
+
+    std::vector<const Stop*> GetAll() const {
+        std::vector<const Stop*> result;
+        for (const Stop& stop : stops) {
+            result.push_back(&stop);
+        }
+        return result;
+    }
+};
+
+Stops MakeRandomStops(unsigned seed, size_t count) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> lat(55.60, 55.90);
+    std::uniform_real_distribution<double> lng(37.40, 37.80);
+    Stops result;
+    for (size_t i = 0; i < count; ++i) {
+        result.Add("Stop " + std::to_string(i), {lat(generator), lng(generator)});
+    }
+    //Несколько остановок в одной точке: порядок между ними задаёт имя
+    for (size_t i = 0; i < 3; ++i) {
+        result.Add("Twin " + std::to_string(i), result.stops.front().coordinates);
+    }
+    return result;
+}
+
+//Все остановки по возрастанию расстояния, при равенстве — по имени
+std::vector<spatial::StopDistance> SortByDistance(const Stops& stops, geo::Coordinates point) {
+    const geo::SpherePoint position = geo::ToSpherePoint(point);
+    std::vector<spatial::StopDistance> result;
+    for (const Stop& stop : stops.stops) {
+        result.push_back({&stop, geo::ComputeDistance(position, stop.position)});
+    }
+    std::sort(result.begin(), result.end(), [](const spatial::StopDistance& lhs, const spatial::StopDistance& rhs) {
+        return std::tie(lhs.distance, lhs.stop->name) < std::tie(rhs.distance, rhs.stop->name);
+    });
+    return result;
+}
+
+void AssertSameStops(const std::vector<spatial::StopDistance>& actual, const std::vector<spatial::StopDistance>& expected) {
+    ASSERT_EQUAL(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQUAL(actual[i].stop, expected[i].stop);
+        ASSERT_EQUAL(actual[i].distance, expected[i].distance);
+    }
+}
+
+//Точки запросов: внутри города, на остановке и далеко за пределами сетки
+std::vector<geo::Coordinates> MakeQueries(const Stops& stops, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> lat(55.50, 56.00);
+    std::uniform_real_distribution<double> lng(37.30, 37.90);
+    std::vector<geo::Coordinates> result = {stops.stops.front().coordinates, {59.93, 30.33}, {55.75, 37.0}};
+    for (int i = 0; i < 50; ++i) {
+        result.push_back({lat(generator), lng(generator)});
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(StopIndexFindNearestMatchesBruteForce) {
+    const Stops stops = MakeRandomStops(1, 1000);
+    const spatial::StopIndex index(stops.GetAll());
+    ASSERT_EQUAL(index.GetStopsCount(), stops.stops.size());
+    for (const geo::Coordinates point : MakeQueries(stops, 2)) {
+        const std::vector<spatial::StopDistance> all = SortByDistance(stops, point);
+        for (size_t count : {size_t{1}, size_t{5}, size_t{40}, all.size() + 10}) {
+            const std::vector<spatial::StopDistance> expected(all.begin(), all.begin() + std::min(count, all.size()));
+            AssertSameStops(index.FindNearest(point, count), expected);
+        }
+    }
+}
+
+TEST(StopIndexFindWithinRadiusMatchesBruteForce) {
+    const Stops stops = MakeRandomStops(3, 1000);
+    const spatial::StopIndex index(stops.GetAll());
+    for (const geo::Coordinates point : MakeQueries(stops, 4)) {
+        for (double radius : {0.0, 300.0, 2000.0, 100000.0}) {
+            std::vector<spatial::StopDistance> expected = SortByDistance(stops, point);
+            std::erase_if(expected, [radius](const spatial::StopDistance& item) {
+                return item.distance > radius;
+            });
+            AssertSameStops(index.FindWithinRadius(point, radius), expected);
+        }
+    }
+}
+
+TEST(StopIndexFindInAreaMatchesBruteForce) {
+    const Stops stops = MakeRandomStops(5, 1000);
+    const spatial::StopIndex index(stops.GetAll());
+    std::mt19937 generator(6);
+    std::uniform_real_distribution<double> lat(55.55, 55.95);
+    std::uniform_real_distribution<double> lng(37.35, 37.85);
+    std::vector<spatial::Area> areas;
+    for (int i = 0; i < 50; ++i) {
+        const double lat1 = lat(generator), lat2 = lat(generator);
+        const double lng1 = lng(generator), lng2 = lng(generator);
+        areas.push_back({{std::min(lat1, lat2), std::min(lng1, lng2)}, {std::max(lat1, lat2), std::max(lng1, lng2)}});
+    }
+    //Границы включаются: область из одной точки находит все остановки в ней
+    areas.push_back({stops.stops.front().coordinates, stops.stops.front().coordinates});
+    areas.push_back({{50, 30}, {51, 31}});
+    for (const spatial::Area& area : areas) {
+        std::vector<const Stop*> expected;
+        for (const Stop& stop : stops.stops) {
+            if (stop.coordinates.lat >= area.min.lat && stop.coordinates.lat <= area.max.lat
+                && stop.coordinates.lng >= area.min.lng && stop.coordinates.lng <= area.max.lng) {
+                expected.push_back(&stop);
+            }
+        }
+        std::sort(expected.begin(), expected.end(), [](const Stop* lhs, const Stop* rhs) {
+            return lhs->name < rhs->name;
+        });
+        ASSERT_EQUAL(index.FindInArea(area), expected);
+    }
+    ASSERT_EQUAL(index.FindInArea(areas[50]).size(), 4u);
+}
+
+TEST(StopIndexHandlesDegenerateInput) {
+    const spatial::StopIndex empty;
+    ASSERT(empty.FindNearest({55.7, 37.6}, 3).empty());
+    ASSERT(empty.FindWithinRadius({55.7, 37.6}, 1000).empty());
+    ASSERT(empty.FindInArea({{55, 37}, {56, 38}}).empty());
+
+    //Все остановки на одной широте: ячейки не должны вырождаться
+    Stops line;
+    for (int i = 0; i < 20; ++i) {
+        line.Add("Stop " + std::to_string(i), {55.7, 37.5 + i * 0.01});
+    }
+    const spatial::StopIndex index(line.GetAll());
+    std::vector<spatial::StopDistance> nearest = SortByDistance(line, {55.7, 37.555});
+    nearest.resize(4);
+    AssertSameStops(index.FindNearest({55.7, 37.555}, 4), nearest);
+    ASSERT_EQUAL(index.FindInArea({line.stops[0].coordinates, line.stops[2].coordinates}).size(), 3u);
+}
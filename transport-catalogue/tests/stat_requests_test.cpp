@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "geo.h"
+#include "json.h"
+#include "json_network.h"
+#include "json_reader.h"
+#include "memory_usage.h"
+#include "stop_search.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Справочник и маршрутизатор документа, отвечающие на отдельные запросы
+struct Responder {
+    explicit Responder(const TestNetwork& network)
+        : input(MakeInputDocument(network.data))
+        , reader(std::string_view(input))
+        , db(reader.MakeDB())
+        , router(db, reader.ParseRoutingSettings()) {
+    }
+
+    json::Dict Answer(const json::Dict& request, const memory::Reports& reports = {}) const {
+        std::ostringstream out;
+        reader.PrintResponse(out, request, db, router, "<svg/>"sv, reports, json::PrintFormat::COMPACT);
+        return json::Load(out.str()).GetRoot().AsMap();
+    }
+
+    std::string input;
+    json::JsonReader reader;
+    const TransportCatalogue& db;
+    const routing::TransportRouter router;
+};
+
+json::Array ToNames(const std::vector<std::string_view>& names) {
+    json::Array result;
+    for (std::string_view name : names) {
+        result.push_back(std::string(name));
+    }
+    return result;
+}
+
+//Ближайшие остановки перебором: по расстоянию, при равенстве — по имени
+std::vector<std::pair<double, std::string_view>> SortByDistance(const TestNetwork& network, geo::Coordinates point) {
+    const geo::SpherePoint position = geo::ToSpherePoint(point);
+    std::vector<std::pair<double, std::string_view>> result;
+    for (const Stop& stop : network.data.stops) {
+        result.emplace_back(geo::ComputeDistance(position, geo::ToSpherePoint(stop.coordinates)), stop.name);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+TEST(StatRequestsAnswerNearestStops) {
+    const TestNetwork network = MakeRandomNetwork(111, 80, 5, 5);
+    const Responder responder(network);
+    std::mt19937 generator(111);
+    std::uniform_real_distribution<double> lat(55.55, 55.95);
+    std::uniform_real_distribution<double> lng(37.35, 37.85);
+    for (int i = 0; i < 50; ++i) {
+        const geo::Coordinates point{lat(generator), lng(generator)};
+        const std::vector<std::pair<double, std::string_view>> expected = SortByDistance(network, point);
+        //count по умолчанию — 1; отрицательный — пустой ответ; больше числа остановок — все
+        for (const int count : {0, 1, 7, -3, 200}) {
+            json::Dict request{{"id"s, i}, {"type"s, "NearestStops"s}, {"latitude"s, point.lat}, {"longitude"s, point.lng}};
+            if (count) {
+                request.emplace("count"s, count);
+            }
+            const json::Dict response = responder.Answer(request);
+            ASSERT(response.at("request_id"sv) == json::Node(i));
+            const json::Array& stops = response.at("stops"sv).AsArray();
+            const size_t expected_size = count ? std::min<size_t>(std::max(count, 0), expected.size()) : 1;
+            ASSERT_EQUAL(stops.size(), expected_size);
+            for (size_t j = 0; j < stops.size(); ++j) {
+                const json::Dict& stop = stops[j].AsMap();
+                ASSERT_EQUAL(stop.at("name"sv).AsString(), std::string(expected[j].second));
+                //Расстояние выводится с 6 значащими цифрами
+                ASSERT(std::abs(stop.at("distance"sv).AsDouble() - expected[j].first) <= 1e-5 * std::max(1.0, expected[j].first));
+            }
+        }
+    }
+}
+
+TEST(StatRequestsAnswerStopsInArea) {
+    const TestNetwork network = MakeRandomNetwork(112, 80, 5, 5);
+    const Responder responder(network);
+    std::mt19937 generator(112);
+    std::uniform_real_distribution<double> lat(55.55, 55.95);
+    std::uniform_real_distribution<double> lng(37.35, 37.85);
+    for (int i = 0; i < 100; ++i) {
+        double min_lat = lat(generator);
+        double max_lat = lat(generator);
+        double min_lng = lng(generator);
+        double max_lng = lng(generator);
+        if (min_lat > max_lat) {
+            std::swap(min_lat, max_lat);
+        }
+        if (min_lng > max_lng) {
+            std::swap(min_lng, max_lng);
+        }
+        if (i == 0) {
+            //Границы включаются: область из одной точки — остановка в ней
+            min_lat = max_lat = network.data.stops[3].coordinates.lat;
+            min_lng = max_lng = network.data.stops[3].coordinates.lng;
+        }
+        std::vector<std::string_view> expected;
+        for (const Stop& stop : network.data.stops) {
+            if (stop.coordinates.lat >= min_lat && stop.coordinates.lat <= max_lat
+                && stop.coordinates.lng >= min_lng && stop.coordinates.lng <= max_lng) {
+                expected.push_back(stop.name);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        const json::Dict response = responder.Answer({{"id"s, i}, {"type"s, "StopsInArea"s},
+                                                      {"min_latitude"s, min_lat}, {"min_longitude"s, min_lng},
+                                                      {"max_latitude"s, max_lat}, {"max_longitude"s, max_lng}});
+        ASSERT(response.at("request_id"sv) == json::Node(i));
+        ASSERT(response.at("stops"sv) == json::Node(ToNames(expected)));
+        if (i == 0) {
+            ASSERT_EQUAL(expected.size(), 1u);
+        }
+    }
+}
+
+TEST(StatRequestsAnswerDirectBuses) {
+    const TestNetwork network = MakeRandomNetwork(113, 30, 10, 6);
+    const Responder responder(network);
+    int id = 0;
+    for (size_t from = 0; from < 30; from += 3) {
+        for (size_t to = 0; to < 30; to += 2) {
+            const std::string from_name = "Stop "s + std::to_string(from);
+            const std::string to_name = "Stop "s + std::to_string(to);
+            const json::Dict response = responder.Answer({{"id"s, ++id}, {"type"s, "DirectBuses"s},
+                                                          {"from"s, from_name}, {"to"s, to_name}});
+            ASSERT(response.at("request_id"sv) == json::Node(id));
+            ASSERT(response.at("buses"sv) == json::Node(ToNames(*responder.db.GetDirectBuses(from_name, to_name))));
+        }
+    }
+    const json::Dict missing = responder.Answer({{"id"s, 0}, {"type"s, "DirectBuses"s}, {"from"s, "Stop 0"s}, {"to"s, "No such stop"s}});
+    ASSERT(missing.at("error_message"sv) == json::Node("not found"s));
+}
+
+TEST(StatRequestsAnswerStopSearch) {
+    const TestNetwork network = MakeRandomNetwork(114, 150, 3, 4);
+    const Responder responder(network);
+    const search::StopSearch& search = responder.db.GetStopSearch();
+    for (const std::string& query : {"Stop 1"s, "stop 12"s, "Stpo 4"s, "S"s, "Bus"s, ""s}) {
+        //Без полей count и max_errors — 10 остановок и допуск по длине запроса
+        const json::Dict response = responder.Answer({{"id"s, 1}, {"type"s, "StopSearch"s}, {"query"s, query}});
+        const auto expected = search.Find(query, 10, search::StopSearch::GetDefaultMaxErrors(query));
+        const json::Array& stops = response.at("stops"sv).AsArray();
+        ASSERT_EQUAL(stops.size(), expected.size());
+        for (size_t i = 0; i < stops.size(); ++i) {
+            ASSERT_EQUAL(stops[i].AsMap().at("name"sv).AsString(), std::string(expected[i].stop->name));
+            ASSERT(stops[i].AsMap().at("errors"sv) == json::Node(expected[i].errors));
+        }
+        for (const auto& [count, max_errors] : {std::pair{3, 0}, std::pair{25, 2}, std::pair{-1, 1}}) {
+            const json::Dict limited = responder.Answer({{"id"s, 2}, {"type"s, "StopSearch"s}, {"query"s, query},
+                                                         {"count"s, count}, {"max_errors"s, max_errors}});
+            ASSERT_EQUAL(limited.at("stops"sv).AsArray().size(), search.Find(query, std::max(count, 0), max_errors).size());
+        }
+    }
+}
+
+TEST(StatRequestsAnswerStats) {
+    const TestNetwork network = MakeRandomNetwork(115, 10, 2, 4);
+    const Responder responder(network);
+    memory::Report catalogue;
+    catalogue.Add("stops"s, {1000, 10});
+    catalogue.Add("buses"s, {500, 2});
+    memory::Report router;
+    router.Add("graph"s, {3000000000, 7});
+    //Компоненты выводятся по алфавиту, из одноимённых — последний
+    const memory::Reports reports{{"router"s, memory::Report{}}, {"catalogue"s, catalogue}, {"router"s, router}};
+    const json::Dict response = responder.Answer({{"id"s, 5}, {"type"s, "Stats"s}}, reports);
+    ASSERT(response.at("request_id"sv) == json::Node(5));
+    const json::Dict& components = response.at("components"sv).AsMap();
+    ASSERT_EQUAL(components.size(), 2u);
+    ASSERT(components.at("catalogue"sv).AsMap().at("bytes"sv) == json::Node(1500));
+    ASSERT(components.at("catalogue"sv).AsMap().at("parts"sv).AsMap().at("buses"sv)
+           == json::Node(json::Dict{{"bytes"s, 500}, {"items"s, 2}}));
+    //Счётчики больше int выводятся вещественными числами
+    ASSERT(components.at("router"sv).AsMap().at("bytes"sv) == json::Node(3e9));
+    //Вещественные выводятся с 6 значащими цифрами
+    ASSERT(response.at("total_bytes"sv).IsPureDouble());
+    ASSERT(std::abs(response.at("total_bytes"sv).AsDouble() - 3000001500.0) <= 1e-5 * 3e9);
+}
+
+TEST(StatRequestsRejectInvalidRequests) {
+    const TestNetwork network = MakeRandomNetwork(116, 10, 2, 4);
+    const Responder responder(network);
+    ASSERT_THROWS(responder.Answer({{"id"s, 1}, {"type"s, "Unknown"s}}), std::invalid_argument);
+    ASSERT_THROWS(responder.Answer({{"id"s, 1}, {"type"s, "NearestStops"s}, {"latitude"s, 55.7}}), std::out_of_range);
+    ASSERT_THROWS(responder.Answer({{"id"s, 1}, {"type"s, "StopsInArea"s}, {"min_latitude"s, 55.7}}), std::out_of_range);
+    ASSERT_THROWS(responder.Answer({{"id"s, 1}, {"type"s, "DirectBuses"s}, {"from"s, "Stop 0"s}}), std::out_of_range);
+    ASSERT_THROWS(responder.Answer({{"id"s, 1}, {"type"s, "StopSearch"s}, {"query"s, 5}}), std::logic_error);
+    ASSERT_THROWS(responder.Answer({{"type"s, "Stats"s}}), std::out_of_range);
+
+    //Все запросы разбираются до вывода: ошибка в последнем не оставляет начатого ответа
+    const std::string input = MakeInputDocument(network.data, json::Array{
+        json::Dict{{"id"s, 1}, {"type"s, "Stop"s}, {"name"s, "Stop 0"s}},
+        json::Dict{{"id"s, 2}, {"type"s, "Map"s}},
+        json::Dict{{"id"s, 3}, {"type"s, "Unknown"s}},
+    });
+    json::JsonReader reader{std::string_view(input)};
+    const TransportCatalogue& db = reader.MakeDB();
+    const routing::TransportRouter router(db, reader.ParseRoutingSettings());
+    std::ostringstream out;
+    ASSERT_THROWS(reader.PrintJson(out, router, ""sv, {}), std::invalid_argument);
+    ASSERT(out.str().empty());
+}
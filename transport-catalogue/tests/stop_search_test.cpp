@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "stop_search.h"
+#include "testing.h"
+
+using namespace std::literals;
+
+namespace {
+
+//Часть имени и её вид после приведения к нижнему регистру
+struct Syllable {
+    std::string_view text;
+    std::u32string_view key;
+};
+
+constexpr Syllable SYLLABLES[] = {
+    {"Ле"sv, U"ле"sv}, {"ЛЁ"sv, U"ле"sv}, {"нин"sv, U"нин"sv}, {"ская"sv, U"ская"sv}, {"ёл"sv, U"ел"sv},
+    {"Park"sv, U"park"sv}, {"park"sv, U"park"sv}, {"a"sv, U"a"sv}, {"B"sv, U"b"sv}, {" "sv, U" "sv},
+};
+
+struct NamedStops {
+    std::deque<std::string> names;
+    std::deque<Stop> stops;
+    //Ключи в том же порядке, что stops
+    std::vector<std::u32string> keys;
+
+    void Add(const std::vector<Syllable>& syllables) {
+        std::string name;
+        std::u32string key;
+        for (const Syllable& syllable : syllables) {
+            name += syllable.text;
+            key += syllable.key;
+        }
+        //Одинаковые имена различаются номером; номер стоит в конце и на поиск по началу не влияет
+        name += "#" + std::to_string(stops.size());
+        for (char c : "#" + std::to_string(stops.size())) {
+            key += static_cast<char32_t>(c);
+        }
+        stops.push_back({names.emplace_back(std::move(name)), {}, {}});
+        keys.push_back(std::move(key));
+    }
+
+    std::vector<const Stop*> GetAll(size_t begin = 0, size_t end = SIZE_MAX) const {
+        std::vector<const Stop*> result;
+        for (size_t i = begin; i < std::min(end, stops.size()); ++i) {
+            result.push_back(&stops[i]);
+        }
+        return result;
+    }
+};
+
+std::vector<Syllable> MakeRandomSyllables(std::mt19937& generator, size_t max_count) {
+    std::vector<Syllable> result(1 + generator() % max_count);
+    for (Syllable& syllable : result) {
+        syllable = SYLLABLES[generator() % std::size(SYLLABLES)];
+    }
+    return result;
+}
+
+NamedStops MakeRandomStops(unsigned seed, size_t count) {
+    std::mt19937 generator(seed);
+    NamedStops result;
+    for (size_t i = 0; i < count; ++i) {
+        result.Add(MakeRandomSyllables(generator, 4));
+    }
+    return result;
+}
+
+//Запросы из тех же слогов: часть — начала имён, часть — начала с опечатками в слог
+std::vector<std::vector<Syllable>> MakeQueries(unsigned seed, size_t count) {
+    std::mt19937 generator(seed);
+    std::vector<std::vector<Syllable>> result;
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(MakeRandomSyllables(generator, 3));
+    }
+    return result;
+}
+
+std::pair<std::string, std::u32string> Join(const std::vector<Syllable>& syllables) {
+    std::pair<std::string, std::u32string> result;
+    for (const Syllable& syllable : syllables) {
+        result.first += syllable.text;
+        result.second += syllable.key;
+    }
+    return result;
+}
+
+//Наименьшее расстояние Левенштейна от query до начала key
+int CountPrefixErrors(std::u32string_view query, std::u32string_view key) {
+    std::vector<int> row(query.size() + 1);
+    for (size_t i = 0; i < row.size(); ++i) {
+        row[i] = static_cast<int>(i);
+    }
+    int best = row.back();
+    for (char32_t c : key) {
+        std::vector<int> next(row.size());
+        next[0] = row[0] + 1;
+        for (size_t i = 1; i < row.size(); ++i) {
+            next[i] = std::min({row[i - 1] + (query[i - 1] == c ? 0 : 1), row[i] + 1, next[i - 1] + 1});
+        }
+        row = std::move(next);
+        best = std::min(best, row.back());
+    }
+    return best;
+}
+
+//Все остановки с числом ошибок, по возрастанию ошибок, затем ключа и имени
+std::vector<search::StopMatch> RankAll(const NamedStops& stops, std::u32string_view query) {
+    std::vector<std::tuple<int, std::u32string_view, std::string_view, const Stop*>> ranked;
+    for (size_t i = 0; i < stops.stops.size(); ++i) {
+        ranked.emplace_back(CountPrefixErrors(query, stops.keys[i]), stops.keys[i], stops.stops[i].name, &stops.stops[i]);
+    }
+    std::sort(ranked.begin(), ranked.end());
+    std::vector<search::StopMatch> result;
+    for (const auto& [errors, key, name, stop] : ranked) {
+        result.push_back({stop, errors});
+    }
+    return result;
+}
+
+//Поиск расширяет допуск, пока не наберёт count совпадений, но не дальше max_errors
+std::vector<search::StopMatch> FindByBruteForce(const NamedStops& stops, std::u32string_view query, size_t count, int max_errors) {
+    const std::vector<search::StopMatch> ranked = RankAll(stops, query);
+    int allowed = 0;
+    while (allowed < max_errors && std::count_if(ranked.begin(), ranked.end(), [allowed](const search::StopMatch& match) {
+        return match.errors <= allowed;
+    }) < static_cast<std::ptrdiff_t>(count)) {
+        ++allowed;
+    }
+    std::vector<search::StopMatch> result;
+    for (const search::StopMatch& match : ranked) {
+        if (match.errors <= allowed && result.size() < count) {
+            result.push_back(match);
+        }
+    }
+    return result;
+}
+
+void AssertSameMatches(const std::vector<search::StopMatch>& actual, const std::vector<search::StopMatch>& expected) {
+    ASSERT_EQUAL(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQUAL(actual[i].stop->name, expected[i].stop->name);
+        ASSERT_EQUAL(actual[i].errors, expected[i].errors);
+    }
+}
+
+void AssertSameSearch(const search::StopSearch& actual, const search::StopSearch& expected, const std::string& query) {
+    ASSERT_EQUAL(actual.FindByPrefix(query, 10), expected.FindByPrefix(query, 10));
+    for (int max_errors : {0, 1, 2}) {
+        AssertSameMatches(actual.Find(query, 10, max_errors), expected.Find(query, 10, max_errors));
+    }
+}
+
+} // namespace
+
+TEST(StopSearchFindByPrefixMatchesBruteForce) {
+    const NamedStops stops = MakeRandomStops(1, 500);
+    const search::StopSearch index(stops.GetAll());
+    for (const auto& syllables : MakeQueries(2, 100)) {
+        const auto [query, key] = Join(syllables);
+        for (size_t count : {size_t{1}, size_t{7}, size_t{1000}}) {
+            std::vector<const Stop*> expected;
+            for (const search::StopMatch& match : RankAll(stops, key)) {
+                if (match.errors == 0 && expected.size() < count) {
+                    expected.push_back(match.stop);
+                }
+            }
+            ASSERT_EQUAL(index.FindByPrefix(query, count), expected);
+        }
+    }
+}
+
+TEST(StopSearchFindMatchesBruteForce) {
+    const NamedStops stops = MakeRandomStops(3, 300);
+    const search::StopSearch index(stops.GetAll());
+    for (const auto& syllables : MakeQueries(4, 100)) {
+        const auto [query, key] = Join(syllables);
+        for (size_t count : {size_t{1}, size_t{5}, size_t{50}}) {
+            for (int max_errors : {0, 1, 2}) {
+                AssertSameMatches(index.Find(query, count, max_errors), FindByBruteForce(stops, key, count, max_errors));
+            }
+        }
+    }
+}
+
+TEST(StopSearchAddMatchesRebuild) {
+    const NamedStops stops = MakeRandomStops(5, 300);
+    search::StopSearch added(stops.GetAll(0, 200));
+    added.Add(stops.GetAll(200, 250));
+    added.Add(stops.GetAll(250));
+    const search::StopSearch rebuilt(stops.GetAll());
+    search::StopSearch from_empty;
+    from_empty.Add(stops.GetAll());
+    for (const auto& syllables : MakeQueries(6, 50)) {
+        const std::string query = Join(syllables).first;
+        AssertSameSearch(added, rebuilt, query);
+        AssertSameSearch(from_empty, rebuilt, query);
+    }
+}
+
+TEST(StopSearchFoldsCase) {
+    std::deque<Stop> stops = {{"Парк Горького"sv, {}, {}}, {"Ёлки"sv, {}, {}}, {"PARK avenue"sv, {}, {}}, {"Ѐнисей"sv, {}, {}}};
+    std::vector<const Stop*> pointers;
+    for (const Stop& stop : stops) {
+        pointers.push_back(&stop);
+    }
+    const search::StopSearch index(pointers);
+    ASSERT_EQUAL(index.FindByPrefix("парк г"sv, 5), std::vector<const Stop*>{&stops[0]});
+    ASSERT_EQUAL(index.FindByPrefix("ЕЛК"sv, 5), std::vector<const Stop*>{&stops[1]});
+    ASSERT_EQUAL(index.FindByPrefix("park A"sv, 5), std::vector<const Stop*>{&stops[2]});
+    ASSERT_EQUAL(index.FindByPrefix("ѐн"sv, 5), std::vector<const Stop*>{&stops[3]});
+    ASSERT_EQUAL(index.FindByPrefix(""sv, 5).size(), 4u);
+    //Опечатка считается по символам, а не по байтам UTF-8
+    const std::vector<search::StopMatch> matches = index.Find("Парк Гарького"sv, 5, 1);
+    ASSERT_EQUAL(matches.size(), 1u);
+    ASSERT_EQUAL(matches[0].stop, &stops[0]);
+    ASSERT_EQUAL(matches[0].errors, 1);
+    //Некорректный байт UTF-8 — один чужой символ: точно не совпадает, с одной ошибкой находится
+    ASSERT(index.FindByPrefix("\xFF\xD0\xBF"sv, 5).empty());
+    const std::vector<search::StopMatch> broken = index.Find("\xFF\xD0\xBF"sv, 5, 1);
+    ASSERT_EQUAL(broken.size(), 1u);
+    ASSERT_EQUAL(broken[0].stop, &stops[0]);
+    ASSERT(index.FindByPrefix("\xD0"sv, 5).empty());
+}
+
+TEST(StopSearchDefaultMaxErrorsCountsCharacters) {
+    ASSERT_EQUAL(search::StopSearch::GetDefaultMaxErrors("abc"sv), 0);
+    ASSERT_EQUAL(search::StopSearch::GetDefaultMaxErrors("абв"sv), 0);
+    ASSERT_EQUAL(search::StopSearch::GetDefaultMaxErrors("парк"sv), 1);
+    ASSERT_EQUAL(search::StopSearch::GetDefaultMaxErrors("Горького"sv), 2);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+//Путь во временном каталоге, уникальный для процесса; файл удаляется вместе с объектом
+class TempFile {
+public:
+    explicit TempFile(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() / ("tc_tests_" + std::to_string(getpid()) + "_" + name)) {
+        std::filesystem::remove(path_);
+    }
+
+    ~TempFile() {
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    std::string GetPath() const {
+        return path_.string();
+    }
+
+    std::string Read() const {
+        std::ifstream in(path_, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    void Write(const std::string& content) const {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+private:
+    std::filesystem::path path_;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "domain.h"
+#include "geo.h"
+#include "testing.h"
+#include "transport_catalogue.h"
+
+/*
+ * Сеть для тестов: владеет именами и списками остановок, на которые ссылается data,
+ * поэтому должна жить, пока используется data. Имена и маршруты хранятся в deque,
+ * чтобы ссылки на них не менялись при добавлении.
+ */
+struct TestNetwork {
+    std::deque<std::string> names;
+    std::deque<std::vector<std::string_view>> routes;
+    CatalogueData data;
+
+    std::string_view AddName(std::string name) {
+        return names.emplace_back(std::move(name));
+    }
+
+    std::string_view AddStop(std::string name, geo::Coordinates coordinates) {
+        const std::string_view stored = AddName(std::move(name));
+        data.stops.push_back({stored, coordinates, {}});
+        return stored;
+    }
+
+    void AddDistance(std::string_view from, std::string_view to, int distance) {
+        data.distances.push_back({from, to, distance});
+    }
+
+    //stops — как в запросе Bus: для некольцевого маршрута только путь в одну сторону
+    void AddBus(std::string name, const std::vector<std::string_view>& stops, bool is_roundtrip) {
+        std::vector<std::string_view>& route = routes.emplace_back(stops);
+        if (!is_roundtrip) {
+            for (size_t i = stops.size() - 1; i > 0; --i) {
+                route.push_back(stops[i - 1]);
+            }
+        }
+        data.buses.push_back({AddName(std::move(name)), route, 0, is_roundtrip});
+    }
+};
+
+//Случайная сеть в пределах города. Дорожное расстояние между соседними остановками
+//маршрута не короче расстояния по прямой, обратное направление иногда задано отдельно.
+//Маршрут может дважды подряд проходить одну остановку: для неё расстояние 0
+inline TestNetwork MakeRandomNetwork(unsigned seed, size_t stops_count, size_t buses_count, size_t stops_per_bus) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> lat(55.60, 55.90);
+    std::uniform_real_distribution<double> lng(37.40, 37.80);
+    std::uniform_real_distribution<double> detour(1.0, 1.5);
+    TestNetwork network;
+    std::vector<std::string_view> stops;
+    for (size_t i = 0; i < stops_count; ++i) {
+        stops.push_back(network.AddStop("Stop " + std::to_string(i), {lat(generator), lng(generator)}));
+    }
+    const auto coordinates_of = [&network](std::string_view name) {
+        return std::find_if(network.data.stops.begin(), network.data.stops.end(), [name](const Stop& stop) {
+            return stop.name == name;
+        })->coordinates;
+    };
+    for (size_t bus = 0; bus < buses_count; ++bus) {
+        std::vector<std::string_view> route;
+        for (size_t i = 0; i < stops_per_bus; ++i) {
+            route.push_back(stops[generator() % stops.size()]);
+        }
+        const bool is_roundtrip = bus % 2 == 0;
+        if (is_roundtrip) {
+            route.push_back(route.front());
+        }
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            const double straight = geo::ComputeDistance(geo::ToSpherePoint(coordinates_of(route[i])), geo::ToSpherePoint(coordinates_of(route[i + 1])));
+            network.AddDistance(route[i], route[i + 1], static_cast<int>(std::ceil(straight * detour(generator))));
+            if (generator() % 3 == 0) {
+                network.AddDistance(route[i + 1], route[i], static_cast<int>(std::ceil(straight * detour(generator))));
+            }
+        }
+        network.AddBus("Bus " + std::to_string(bus), route, is_roundtrip);
+    }
+    return network;
+}
+
+//Справочники отвечают одинаково: тот же порядок остановок, те же маршруты,
+//их статистика, расстояния и маршруты через каждую остановку
+inline void AssertSameCatalogue(const TransportCatalogue& actual, const TransportCatalogue& expected) {
+    ASSERT_EQUAL(actual.GetStopsList().size(), expected.GetStopsList().size());
+    for (size_t i = 0; i < expected.GetStopsList().size(); ++i) {
+        const Stop& actual_stop = *actual.GetStopsList()[i];
+        const Stop& expected_stop = *expected.GetStopsList()[i];
+        ASSERT_EQUAL(actual_stop.name, expected_stop.name);
+        ASSERT_EQUAL(actual_stop.coordinates, expected_stop.coordinates);
+        ASSERT_EQUAL(actual.GetBusesOnStop(actual_stop.name), expected.GetBusesOnStop(expected_stop.name));
+    }
+    const auto actual_buses = actual.GetBuses();
+    const auto expected_buses = expected.GetBuses();
+    ASSERT_EQUAL(actual_buses.size(), expected_buses.size());
+    for (const auto& [name, bus] : expected_buses) {
+        const auto it = actual_buses.find(name);
+        ASSERT(it != actual_buses.end());
+        ASSERT(std::equal(it->second->stops.begin(), it->second->stops.end(), bus->stops.begin(), bus->stops.end()));
+        ASSERT_EQUAL(it->second->is_circle, bus->is_circle);
+        const BusInfo actual_info = actual.GetBusInfo(name);
+        const BusInfo expected_info = expected.GetBusInfo(name);
+        ASSERT_EQUAL(actual_info.stops_on_route, expected_info.stops_on_route);
+        ASSERT_EQUAL(actual_info.unique_stops, expected_info.unique_stops);
+        ASSERT_EQUAL(actual_info.route_length, expected_info.route_length);
+        ASSERT_EQUAL(actual_info.curvature, expected_info.curvature);
+        for (size_t i = 1; i < bus->stops.size(); ++i) {
+            ASSERT_EQUAL(actual.GetDistance(bus->stops[i - 1], bus->stops[i]), expected.GetDistance(bus->stops[i - 1], bus->stops[i]));
+        }
+    }
+}
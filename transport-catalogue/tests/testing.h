@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Минимальный каркас тестов без внешних зависимостей.
+ * TEST(Name) объявляет тест и регистрирует его; тесты всех файлов запускает tests/main.cpp.
+ * Невыполненная проверка бросает AssertionError: тест прерывается, остальные продолжаются.
+ */
+namespace testing {
+
+class AssertionError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+struct TestCase {
+    std::string name;
+    std::function<void()> body;
+};
+
+std::vector<TestCase>& GetTests();
+
+struct Registrar {
+    Registrar(std::string name, std::function<void()> body) {
+        GetTests().push_back({std::move(name), std::move(body)});
+    }
+};
+
+template <typename T>
+void PrintValue(std::ostream& out, const T& value) {
+    if constexpr (requires { out << value; }) {
+        out << value;
+    } else {
+        out << "<value>";
+    }
+}
+
+inline void Assert(bool condition, const char* text, const char* file, int line) {
+    if (!condition) {
+        std::ostringstream message;
+        message << file << ':' << line << ": ASSERT("  << text << ") failed";
+        throw AssertionError(message.str());
+    }
+}
+
+template <typename T, typename U>
+void AssertEqual(const T& actual, const U& expected, const char* actual_text, const char* expected_text,
+                 const char* file, int line) {
+    if (!(actual == expected)) {
+        std::ostringstream message;
+        message << file << ':' << line << ": " << actual_text << " != " << expected_text << " (";
+        PrintValue(message, actual);
+        message << " != ";
+        PrintValue(message, expected);
+        message << ')';
+        throw AssertionError(message.str());
+    }
+}
+
+} // namespace testing
+
+#define TEST(name) \
+    static void name(); \
+    static const testing::Registrar name##_registrar(#name, name); \
+    static void name()
+
+#define ASSERT(condition) testing::Assert(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#define ASSERT_EQUAL(actual, expected) testing::AssertEqual((actual), (expected), #actual, #expected, __FILE__, __LINE__)
+
+//Выражение должно бросить исключение типа exception (или производного)
+#define ASSERT_THROWS(expression, exception) \
+    do { \
+        bool thrown = false; \
+        try { \
+            (void)(expression); \
+        } catch (const exception&) { \
+            thrown = true; \
+        } \
+        testing::Assert(thrown, #expression " throws " #exception, __FILE__, __LINE__); \
+    } while (false)
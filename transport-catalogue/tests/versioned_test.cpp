@@ -0,0 +1,189 @@
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "catalogue_version.h"
+#include "map_renderer.h"
+#include "test_network.h"
+#include "testing.h"
+#include "versioned.h"
+
+using namespace std::literals;
+
+namespace {
+
+std::shared_ptr<const CatalogueVersion> MakeFirstVersion(const TestNetwork& network, renderer::MapRenderer& renderer) {
+    TransportCatalogue db;
+    db.Load(network.data);
+    return std::make_shared<const CatalogueVersion>(std::move(db), routing::RoutingSettings{}, std::nullopt, renderer, memory::Usage{});
+}
+
+} // namespace
+
+TEST(VersionedSnapshotOutlivesPublish) {
+    versioning::Versioned<std::string> versions(std::make_shared<const std::string>("first"));
+    const auto first = versions.Acquire();
+    versions.Publish(std::make_shared<const std::string>("second"));
+    ASSERT_EQUAL(*first, "first"s);
+    ASSERT_EQUAL(*versions.Acquire(), "second"s);
+
+    const auto third = versions.Update([](const std::string& current) {
+        return std::make_shared<const std::string>(current + " and third");
+    });
+    ASSERT_EQUAL(*third, "second and third"s);
+    ASSERT_EQUAL(versions.Acquire(), third);
+}
+
+TEST(VersionedFailedUpdateKeepsCurrentVersion) {
+    versioning::Versioned<int> versions(std::make_shared<const int>(1));
+    const auto before = versions.Acquire();
+    ASSERT_THROWS(versions.Update([](const int&) -> std::shared_ptr<const int> {
+        throw std::invalid_argument("bad delta");
+    }), std::invalid_argument);
+    ASSERT_EQUAL(versions.Acquire(), before);
+    //Мьютекс писателей отпущен
+    versions.Update([](const int& current) {
+        return std::make_shared<const int>(current + 1);
+    });
+    ASSERT_EQUAL(*versions.Acquire(), 2);
+}
+
+TEST(VersionedReadersSeeWholeVersions) {
+    //Версия n — вектор из n одинаковых значений n: читатель не должен увидеть смесь версий
+    versioning::Versioned<std::vector<int>> versions(std::make_shared<const std::vector<int>>(1, 1));
+    std::atomic<bool> done = false;
+    std::atomic<int> errors = 0;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&versions, &done, &errors] {
+            size_t last_seen = 0;
+            while (!done) {
+                const auto snapshot = versions.Acquire();
+                const size_t version = snapshot->size();
+                for (int value : *snapshot) {
+                    errors += static_cast<size_t>(value) != version;
+                }
+                //Версии публикуются по возрастанию
+                errors += version < last_seen;
+                last_seen = version;
+            }
+        });
+    }
+    for (int version = 2; version <= 300; ++version) {
+        versions.Update([version](const std::vector<int>&) {
+            return std::make_shared<const std::vector<int>>(version, version);
+        });
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQUAL(errors.load(), 0);
+    ASSERT_EQUAL(versions.Acquire()->size(), 300u);
+}
+
+TEST(CatalogueVersionLeavesPreviousUntouched) {
+    renderer::MapRenderer renderer(renderer::RenderSettings{});
+    const TestNetwork base = MakeRandomNetwork(21, 30, 5, 5);
+    CatalogueVersions versions(MakeFirstVersion(base, renderer));
+    const auto first = versions.Acquire();
+    const std::string first_map = first->map;
+
+    TestNetwork delta;
+    const std::string_view stop = delta.AddStop("New stop", {55.75, 37.6});
+    delta.AddDistance(stop, "Stop 0"sv, 700);
+    delta.AddBus("New bus", {stop, "Stop 0"sv}, false);
+    versions.Update([&](const CatalogueVersion& current) {
+        return std::make_shared<const CatalogueVersion>(current, delta.data, renderer);
+    });
+    const auto second = versions.Acquire();
+
+    ASSERT(first->db.FindStop("New stop"sv) == nullptr);
+    ASSERT_EQUAL(first->db.GetStopsList().size(), 30u);
+    ASSERT(!first->router.GetRouteTime("New stop"sv, "Stop 0"sv));
+    ASSERT_EQUAL(first->map, first_map);
+
+    ASSERT(second->db.FindStop("New stop"sv) != nullptr);
+    ASSERT_EQUAL(second->db.GetStopsList().size(), 31u);
+    ASSERT_EQUAL(second->db.GetBusInfo("New bus"sv).route_length, 1400);
+    ASSERT(second->router.GetRouteTime("New stop"sv, "Stop 0"sv));
+    ASSERT(second->map != first_map);
+    //Записи прежней версии разделяются, а не копируются
+    ASSERT_EQUAL(second->db.FindStop("Stop 0"sv), first->db.FindStop("Stop 0"sv));
+}
+
+TEST(CatalogueVersionOutlivesItsPredecessor) {
+    renderer::MapRenderer renderer(renderer::RenderSettings{});
+    const TestNetwork base = MakeRandomNetwork(22, 30, 5, 5);
+    TestNetwork delta;
+    const std::string_view stop = delta.AddStop("New stop", {55.75, 37.6});
+    delta.AddDistance(stop, "Stop 1"sv, 500);
+    delta.AddBus("New bus", {stop, "Stop 1"sv}, false);
+
+    std::shared_ptr<const CatalogueVersion> second;
+    {
+        const auto first = MakeFirstVersion(base, renderer);
+        second = std::make_shared<const CatalogueVersion>(*first, delta.data, renderer);
+    }
+    //Имена и записи первой версии живут, пока на них ссылается вторая
+    ASSERT_EQUAL(second->db.FindStop("Stop 1"sv)->name, "Stop 1"sv);
+    ASSERT_EQUAL(second->db.GetBusInfo("Bus 0"sv).stops_on_route, 6u);
+    ASSERT(second->router.GetRouteTime("Stop 1"sv, "New stop"sv));
+}
+
+TEST(CatalogueVersionRejectedDeltaIsNotPublished) {
+    renderer::MapRenderer renderer(renderer::RenderSettings{});
+    const TestNetwork base = MakeRandomNetwork(23, 10, 2, 3);
+    CatalogueVersions versions(MakeFirstVersion(base, renderer));
+    const auto before = versions.Acquire();
+    TestNetwork delta;
+    delta.AddBus("Broken", {"Unknown stop"sv, "Stop 0"sv}, true);
+    ASSERT_THROWS(versions.Update([&](const CatalogueVersion& current) {
+        return std::make_shared<const CatalogueVersion>(current, delta.data, renderer);
+    }), std::invalid_argument);
+    ASSERT_EQUAL(versions.Acquire(), before);
+    ASSERT_EQUAL(before->db.GetBuses().size(), 2u);
+}
+
+TEST(CatalogueVersionReadersDuringUpdates) {
+    renderer::MapRenderer renderer(renderer::RenderSettings{});
+    const TestNetwork base = MakeRandomNetwork(24, 20, 3, 4);
+    CatalogueVersions versions(MakeFirstVersion(base, renderer));
+    std::atomic<bool> done = false;
+    std::atomic<int> errors = 0;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&versions, &done, &errors] {
+            while (!done) {
+                const auto version = versions.Acquire();
+                const size_t stops_count = version->db.GetStopsList().size();
+                //Последняя добавленная остановка версии известна её маршрутизатору
+                const std::string_view newest = version->db.GetStopsList().front()->name;
+                errors += !version->router.GetRouteTime(newest, newest);
+                errors += version->db.GetStopsList().size() != stops_count;
+            }
+        });
+    }
+    std::deque<TestNetwork> deltas;
+    for (int i = 0; i < 30; ++i) {
+        TestNetwork& delta = deltas.emplace_back();
+        const std::string_view stop = delta.AddStop("Added " + std::to_string(i), {55.7 + i / 1000.0, 37.6});
+        delta.AddDistance(stop, "Stop 0"sv, 1000 + i);
+        delta.AddBus("Added bus " + std::to_string(i), {stop, "Stop 0"sv}, false);
+        versions.Update([&](const CatalogueVersion& current) {
+            return std::make_shared<const CatalogueVersion>(current, delta.data, renderer);
+        });
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQUAL(errors.load(), 0);
+    ASSERT_EQUAL(versions.Acquire()->db.GetStopsList().size(), 50u);
+}
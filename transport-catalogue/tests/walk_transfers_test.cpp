@@ -0,0 +1,91 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "json_reader.h"
+#include "reference_router.h"
+#include "test_network.h"
+#include "testing.h"
+#include "transport_router.h"
+
+using namespace std::literals;
+
+namespace {
+
+routing::RoutingSettings MakeWalkSettings(double walk_transfer_distance) {
+    routing::RoutingSettings settings;
+    settings.walk_transfer_distance = walk_transfer_distance;
+    settings.walk_velocity = 4;
+    return settings;
+}
+
+routing::RoutingSettings ParseRoutingSettings(std::string_view routing_settings) {
+    const std::string document = R"({"base_requests": [], "routing_settings": )"s + std::string(routing_settings) + "}"s;
+    return json::JsonReader(document).ParseRoutingSettings();
+}
+
+} // namespace
+
+TEST(WalkTransfersMatchReferenceRoutes) {
+    for (double radius : {0.0, 400.0, 1500.0}) {
+        const TestNetwork network = MakeRandomNetwork(11, 60, 10, 6);
+        TransportCatalogue db;
+        db.Load(network.data);
+        const routing::RoutingSettings settings = MakeWalkSettings(radius);
+        const routing::TransportRouter router(db, settings);
+        AssertSameRouteTimes(db, router, ReferenceRouter(db, settings));
+    }
+}
+
+TEST(WalkTransfersChainNearbyStops) {
+    //Соседние остановки примерно в 334 м друг от друга, автобусов нет
+    TestNetwork network;
+    const std::string_view a = network.AddStop("A", {55.7000, 37.6});
+    const std::string_view b = network.AddStop("B", {55.7030, 37.6});
+    const std::string_view c = network.AddStop("C", {55.7060, 37.6});
+    TransportCatalogue db;
+    db.Load(network.data);
+    const routing::TransportRouter router(db, MakeWalkSettings(400));
+
+    const auto [time, items] = router.BuildRoute(a, c);
+    ASSERT_EQUAL(items.size(), 2u);
+    const auto& first = std::get<routing::WalkEdge>(items[0]);
+    const auto& second = std::get<routing::WalkEdge>(items[1]);
+    ASSERT_EQUAL(first.from, a);
+    ASSERT_EQUAL(first.to, b);
+    ASSERT_EQUAL(second.from, b);
+    ASSERT_EQUAL(second.to, c);
+    const double meters_per_minute = 4 * 1000 / 60.0;
+    ASSERT(std::abs(first.time - geo::ComputeDistance(db.FindStop(a)->coordinates, db.FindStop(b)->coordinates) / meters_per_minute) < 1e-6);
+    ASSERT(std::abs(time - first.time - second.time) < 1e-9);
+
+    //Дальше радиуса пешком не дойти
+    const routing::TransportRouter short_walks(db, MakeWalkSettings(300));
+    ASSERT(!short_walks.GetRouteTime(a, b));
+    ASSERT_EQUAL(short_walks.BuildRoute(a, c).first, -1.0);
+}
+
+TEST(WalkTransfersAreOffByDefault) {
+    ASSERT_EQUAL(ParseRoutingSettings(R"({"bus_wait_time": 2, "bus_velocity": 30})"sv).walk_transfer_distance, 0.0);
+    const routing::RoutingSettings settings = ParseRoutingSettings(
+        R"({"bus_wait_time": 2, "bus_velocity": 30, "walk_transfer_distance": 250, "walk_velocity": 4.5})"sv);
+    ASSERT_EQUAL(settings.walk_transfer_distance, 250.0);
+    ASSERT_EQUAL(settings.walk_velocity, 4.5);
+}
+
+TEST(RoutingSettingsRejectInvalidValues) {
+    for (std::string_view routing_settings : {
+             R"({"bus_wait_time": 2, "bus_velocity": 0})"sv,
+             R"({"bus_wait_time": -1, "bus_velocity": 30})"sv,
+             R"({"bus_wait_time": 2, "bus_velocity": 30, "walk_transfer_distance": 0})"sv,
+             R"({"bus_wait_time": 2, "bus_velocity": 30, "walk_transfer_distance": -100})"sv,
+             R"({"bus_wait_time": 2, "bus_velocity": 30, "walk_transfer_distance": 100, "walk_velocity": 0})"sv,
+             R"({"bus_wait_time": 2, "bus_velocity": 30, "bus_velocities": {"14": -20}})"sv,
+             R"({"bus_wait_time": 2, "bus_velocity": 30, "stop_wait_times": {"A": -1}})"sv}) {
+        ASSERT_THROWS(ParseRoutingSettings(routing_settings), std::invalid_argument);
+    }
+    //Нулевое ожидание допустимо
+    ASSERT_EQUAL(ParseRoutingSettings(R"({"bus_wait_time": 0, "bus_velocity": 30, "stop_wait_times": {"A": 0}})"sv).bus_wait_time, 0);
+}
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <stdexcept>
 
 #include "domain.h"
 #include "geo.h"
+#include "parallel.h"
 #include "transport_catalogue.h"
 
 
@@ -11,24 +13,209 @@ std::size_t TransportCatalogue::PairEqual::operator()(
 	return lhs == rhs;
 }
 
+TransportCatalogue::TransportCatalogue(const TransportCatalogue& other)
+: shared_storages_(other.shared_storages_)
+, stops_index_list_(other.stops_index_list_)
+, buses_index_list_(other.buses_index_list_)
+, stops_(other.stops_)
+, buses_(other.buses_)
+, bus_infos_(other.bus_infos_)
+, route_lengths_(other.route_lengths_)
+, external_distances_(other.external_distances_)
+, stop_index_(other.stop_index_)
+, stop_search_(other.stop_search_)
+, bus_incidence_(other.bus_incidence_)
+{
+	shared_storages_.push_back(other.arena_);
+}
+
 void TransportCatalogue::AddStop(const Stop& stop) {
-	stops_index_list_.push_front(stop);
-	stops_[stops_index_list_.front().name] = &stops_index_list_.front();
+	AddStopRecord(arena_->CopyString(stop.name), stop.coordinates);
 }
 
-void TransportCatalogue::AddBus(const Bus& bus) {
-	std::vector<std::string_view> sv_stop_names;
-	
-	for (const std::string_view stop_name : bus.stops) {
-		sv_stop_names.push_back(stops_[stop_name]->name);
+void TransportCatalogue::AddStopRecord(std::string_view stored_name, geo::Coordinates coordinates) {
+	const Stop* added = arena_->Create<Stop>(Stop{
+		stored_name,
+		coordinates,
+		geo::ToSpherePoint(coordinates)});
+	stops_index_list_.push_front(added);
+	stops_[added->name] = added;
+}
+
+void TransportCatalogue::Load(const CatalogueData& data) {
+	LoadRecords(data, true);
+	BuildIndexes();
+}
+
+void TransportCatalogue::Load(const CatalogueData& data, std::shared_ptr<const void> storage) {
+	shared_storages_.push_back(std::move(storage));
+	LoadRecords(data, false);
+	BuildIndexes();
+}
+
+void TransportCatalogue::Load(const CatalogueData& data, std::shared_ptr<const void> storage, std::shared_ptr<const DistanceTable> distances) {
+	external_distances_ = std::move(distances);
+	Load(data, std::move(storage));
+}
+
+void TransportCatalogue::LoadRecords(const CatalogueData& data, bool copy_names) {
+	stops_.reserve(stops_.size() + data.stops.size());
+	route_lengths_.reserve(route_lengths_.size() + data.distances.size());
+	buses_.reserve(buses_.size() + data.buses.size());
+	bus_infos_.reserve(bus_infos_.size() + data.buses.size());
+
+	for (const Stop& stop : data.stops) {
+		AddStopRecord(copy_names ? arena_->CopyString(stop.name) : stop.name, stop.coordinates);
+	}
+	for (const auto& [from, to, distance] : data.distances) {
+		route_lengths_[{stops_.at(from)->name, stops_.at(to)->name}] = distance;
+	}
+
+	//Маршруты независимы друг от друга и только читают индексы остановок и расстояний,
+	//поэтому разрешение имён и статистика считаются параллельно
+	std::vector<std::vector<std::string_view>> routes(data.buses.size());
+	std::vector<BusInfo> infos(data.buses.size());
+	parallel::For(data.buses.size(), [this, &data, &routes, &infos](size_t i) {
+		routes[i] = ResolveStops(data.buses[i].stops);
+		infos[i] = ComputeBusInfo(routes[i]);
+	});
+	for (size_t i = 0; i < data.buses.size(); ++i) {
+		const Bus& bus = data.buses[i];
+		AddBusRecord(copy_names ? arena_->CopyString(bus.name) : bus.name, bus.is_circle, routes[i], infos[i]);
+	}
+}
+
+void TransportCatalogue::CheckDelta(const CatalogueData& delta) const {
+	using namespace std::literals;
+	std::unordered_set<std::string_view> added_stops;
+	for (const Stop& stop : delta.stops) {
+		if (stops_.count(stop.name)) {
+			throw std::invalid_argument("Stop "s + std::string(stop.name) + " already exists"s);
+		}
+		if (!added_stops.insert(stop.name).second) {
+			throw std::invalid_argument("Stop "s + std::string(stop.name) + " is added twice"s);
+		}
+	}
+	const auto is_known_stop = [this, &added_stops](std::string_view stop_name) {
+		return stops_.count(stop_name) || added_stops.count(stop_name);
+	};
+	for (const auto& [from, to, distance] : delta.distances) {
+		for (const std::string_view stop_name : {from, to}) {
+			if (!is_known_stop(stop_name)) {
+				throw std::invalid_argument("Road distance from "s + std::string(from) + " refers to unknown stop "s + std::string(stop_name));
+			}
+		}
+		//Расстояние становится весом рёбер графа маршрутизатора
+		if (distance < 0) {
+			throw std::invalid_argument("Road distance from "s + std::string(from) + " to "s + std::string(to) + " is negative"s);
+		}
+	}
+	std::unordered_set<std::string_view> added_buses;
+	for (const Bus& bus : delta.buses) {
+		if (buses_.count(bus.name)) {
+			throw std::invalid_argument("Bus "s + std::string(bus.name) + " already exists"s);
+		}
+		if (!added_buses.insert(bus.name).second) {
+			throw std::invalid_argument("Bus "s + std::string(bus.name) + " is added twice"s);
+		}
+		for (const std::string_view stop_name : bus.stops) {
+			if (!is_known_stop(stop_name)) {
+				throw std::invalid_argument("Bus "s + std::string(bus.name) + " refers to unknown stop "s + std::string(stop_name));
+			}
+		}
+	}
+}
+
+CatalogueChanges TransportCatalogue::Update(const CatalogueData& delta) {
+	//Дальше справочник меняется, и ошибка посередине оставила бы его наполовину дополненным
+	CheckDelta(delta);
+
+	//Новое расстояние между известными остановками может изменить длину уже добавленных маршрутов
+	std::unordered_set<std::string_view> touched_stops;
+	for (const auto& [from, to, distance] : delta.distances) {
+		auto from_it = stops_.find(from);
+		if (from_it != stops_.end() && stops_.count(to) && GetDistance(from, to) != distance) {
+			touched_stops.insert(from_it->second->name);
+		}
+	}
+	std::set<std::string_view> touched_buses;
+	for (std::string_view stop_name : touched_stops) {
+		//Остановка известна, поэтому список маршрутов есть
+		const std::vector<const Bus*> buses = bus_incidence_.GetBuses(stop_name).value();
+		for (const Bus* bus : buses) {
+			touched_buses.insert(bus->name);
+		}
+	}
+
+	LoadRecords(delta, true);
+
+	CatalogueChanges changes;
+	for (const Stop& stop : delta.stops) {
+		changes.added_stops.push_back(stops_.at(stop.name));
+	}
+	for (const Bus& bus : delta.buses) {
+		changes.added_buses.push_back(buses_.at(bus.name));
+	}
+	//Записи в арене неизменяемы, поэтому
+	//для маршрута с новой длиной создаётся новая запись с тем же списком остановок
+	for (std::string_view bus_name : touched_buses) {
+		const Bus* old_bus = buses_.at(bus_name);
+		const BusInfo info = ComputeBusInfo(old_bus->stops);
+		const Bus* changed = arena_->Create<Bus>(Bus{old_bus->name, old_bus->stops, info.route_length, old_bus->is_circle});
+		std::replace(buses_index_list_.begin(), buses_index_list_.end(), old_bus, changed);
+		buses_[bus_name] = changed;
+		bus_infos_[bus_name] = info;
+		changes.changed_buses.push_back(changed);
+	}
+	UpdateIndexes(changes);
+	return changes;
+}
+
+void TransportCatalogue::BuildIndexes() {
+	stop_index_ = spatial::StopIndex({stops_index_list_.begin(), stops_index_list_.end()});
+	stop_search_ = search::StopSearch({stops_index_list_.begin(), stops_index_list_.end()});
+	bus_incidence_ = incidence::BusIncidence(stops_index_list_, {buses_index_list_.begin(), buses_index_list_.end()});
+}
+
+void TransportCatalogue::UpdateIndexes(const CatalogueChanges& changes) {
+	//Сетка подбирается под число и разброс всех остановок, а её построение линейно,
+	//поэтому она строится заново. Имена новых остановок вливаются в отсортированный индекс поиска
+	if (!changes.added_stops.empty()) {
+		stop_index_ = spatial::StopIndex({stops_index_list_.begin(), stops_index_list_.end()});
+		stop_search_.Add(changes.added_stops);
+	}
+	//Маршруты в таблице пронумерованы по именам, и новый маршрут сдвигает номера остальных
+	if (!changes.added_buses.empty()) {
+		bus_incidence_ = incidence::BusIncidence(stops_index_list_, {buses_index_list_.begin(), buses_index_list_.end()});
+		return;
 	}
-	int route_length = ComputeRouteDistance(sv_stop_names);
-	buses_index_list_.push_front({bus.name, move(sv_stop_names), route_length, bus.is_circle});
-	buses_[buses_index_list_.front().name] = &buses_index_list_.front();
+	bus_incidence_.AddStops(changes.added_stops);
+	bus_incidence_.ReplaceBuses(changes.changed_buses);
+}
 
-	for (const std::string_view stop_name : bus.stops) {
-		buses_on_stop_[stops_[stop_name]->name].insert(buses_index_list_.front().name);
+void TransportCatalogue::AddBus(const Bus& bus) {
+	std::vector<std::string_view> sv_stop_names = ResolveStops(bus.stops);
+	AddBusRecord(arena_->CopyString(bus.name), bus.is_circle, sv_stop_names, ComputeBusInfo(sv_stop_names));
+}
+
+void TransportCatalogue::AddBusRecord(std::string_view stored_name, bool is_circle, std::span<const std::string_view> stops_on_route, const BusInfo& info) {
+	const Bus* added = arena_->Create<Bus>(Bus{
+		stored_name,
+		arena_->CopyRange(stops_on_route.begin(), stops_on_route.end()),
+		info.route_length,
+		is_circle});
+	buses_index_list_.push_front(added);
+	buses_[added->name] = added;
+	bus_infos_[added->name] = info;
+}
+
+std::vector<std::string_view> TransportCatalogue::ResolveStops(std::span<const std::string_view> stop_names) const {
+	std::vector<std::string_view> result;
+	result.reserve(stop_names.size());
+	for (const std::string_view stop_name : stop_names) {
+		result.push_back(stops_.at(stop_name)->name);
 	}
+	return result;
 }
 
 void TransportCatalogue::AddDistance (std::string_view stop_name, const std::vector<std::pair<std::string_view, int>>& stop_names){
@@ -43,47 +230,68 @@ void TransportCatalogue::AddDistance (std::string_view stop_name, const std::vec
 	for (auto elem: stop_names){
 		std::string_view stop_name_to = stops_[elem.first]->name;
 		route_lengths_[{stop_name_at, stop_name_to}] = elem.second;
-		route_lengths_by_coords_[{stop_name_at, stop_name_to}] = geo::ComputeDistance(
-																stops_[stop_name_at]->coordinates,
-																stops_[stop_name_to]->coordinates);
 	}
 }
 
 int TransportCatalogue::GetDistance(std::string_view from_stop_name, std::string_view to_stop_name) const {
-	auto it = route_lengths_.find({from_stop_name, to_stop_name});
-	if (it == route_lengths_.end()){
-		it = route_lengths_.find({to_stop_name, from_stop_name});
-		if (it == route_lengths_.end()) {
-			return 0;
-		}
+	if (const std::optional<int> distance = FindDistance(from_stop_name, to_stop_name)) {
+		return *distance;
 	}
-	return it->second;
+	return FindDistance(to_stop_name, from_stop_name).value_or(0);
+}
+
+std::optional<int> TransportCatalogue::FindDistance(std::string_view from_stop_name, std::string_view to_stop_name) const {
+	if (auto it = route_lengths_.find({from_stop_name, to_stop_name}); it != route_lengths_.end()) {
+		return it->second;
+	}
+	if (!external_distances_) {
+		return std::nullopt;
+	}
+	//Таблица узнаёт остановки по ключам справочника, а не по содержимому имён
+	const auto from_it = stops_.find(from_stop_name);
+	const auto to_it = stops_.find(to_stop_name);
+	if (from_it == stops_.end() || to_it == stops_.end()) {
+		return std::nullopt;
+	}
+	return external_distances_->Find(from_it->second->name, to_it->second->name);
 }
 
 BusInfo TransportCatalogue::GetBusInfo(const std::string_view bus_name) const {
-	auto it = buses_.find(bus_name);
-	if (it == buses_.end()){
+	auto it = bus_infos_.find(bus_name);
+	if (it == bus_infos_.end()){
 		return {0, 0, 0, 0};
 	}
-	Bus bus = *it->second;
-	double curvature = bus.route_length / ComputeRouteDistanceByCoords(bus.stops);
-	size_t uniq_stops_count = std::unordered_set(bus.stops.begin(), bus.stops.end()).size();
-	return {bus.stops.size(), uniq_stops_count, bus.route_length, curvature};
+	return it->second;
 }
 
-double TransportCatalogue::ComputeRouteDistanceByCoords(const std::vector<std::string_view>& stops_on_route) const {
+BusInfo TransportCatalogue::ComputeBusInfo(std::span<const std::string_view> stops_on_route) const {
+	int route_length = ComputeRouteDistance(stops_on_route);
+	double curvature = route_length / ComputeRouteDistanceByCoords(stops_on_route);
+	size_t uniq_stops_count = std::unordered_set(stops_on_route.begin(), stops_on_route.end()).size();
+	return {stops_on_route.size(), uniq_stops_count, route_length, curvature};
+}
+
+double TransportCatalogue::ComputeRouteDistanceByCoords(std::span<const std::string_view> stops_on_route) const {
+	if (stops_on_route.size() < 2) {
+		return 0;
+	}
+	std::vector<geo::SpherePoint> points;
+	points.reserve(stops_on_route.size());
+	for (const std::string_view stop_name : stops_on_route) {
+		points.push_back(stops_.at(stop_name)->position);
+	}
+	const std::span<const geo::SpherePoint> all_points(points);
+	std::vector<double> distances(points.size() - 1);
+	geo::ComputeDistances(all_points.first(distances.size()), all_points.last(distances.size()), distances);
+
 	double route_length = 0;
-	for (size_t pos = 1; pos < stops_on_route.size(); ++pos) {
-		auto it = route_lengths_by_coords_.find({ stops_on_route[pos - 1], stops_on_route[pos] });
-		if (it == route_lengths_by_coords_.end()){
-			it = route_lengths_by_coords_.find({ stops_on_route[pos], stops_on_route[pos - 1] });
-		}
-		route_length += it->second;
+	for (double distance : distances) {
+		route_length += distance;
 	}
 	return route_length;
 }
 
-int TransportCatalogue::ComputeRouteDistance(const std::vector<std::string_view>& stops_on_route) const{
+int TransportCatalogue::ComputeRouteDistance(std::span<const std::string_view> stops_on_route) const{
 	int route_length = 0;
 	for (size_t pos = 1; pos < stops_on_route.size(); ++pos) {
 		route_length += GetDistance(stops_on_route[pos - 1], stops_on_route[pos]);
@@ -99,12 +307,28 @@ const Stop* TransportCatalogue::FindStop(const std::string_view stop_name) const
 	return it->second;
 }
 
-std::set<std::string_view> TransportCatalogue::GetBusesOnStop(const std::string_view stop_name) const {
-	auto it = buses_on_stop_.find(stop_name);
-	if (it == buses_on_stop_.end()){
-		return {};
+std::optional<std::vector<std::string_view>> TransportCatalogue::GetBusesOnStop(const std::string_view stop_name) const {
+	const std::optional<std::vector<const Bus*>> buses = bus_incidence_.GetBuses(stop_name);
+	if (!buses) {
+		return std::nullopt;
 	}
-	return it->second;
+	std::vector<std::string_view> result;
+	for (const Bus* bus : *buses) {
+		result.push_back(bus->name);
+	}
+	return result;
+}
+
+std::optional<std::vector<std::string_view>> TransportCatalogue::GetDirectBuses(std::string_view from_stop_name, std::string_view to_stop_name) const {
+	const std::optional<std::vector<const Bus*>> buses = bus_incidence_.FindDirectBuses(from_stop_name, to_stop_name);
+	if (!buses) {
+		return std::nullopt;
+	}
+	std::vector<std::string_view> result;
+	for (const Bus* bus : *buses) {
+		result.push_back(bus->name);
+	}
+	return result;
 }
 
 const std::map<std::string_view, const Bus*> TransportCatalogue::GetBuses() const {
@@ -112,6 +336,55 @@ const std::map<std::string_view, const Bus*> TransportCatalogue::GetBuses() cons
 	return buses;
 }
 
-const std::forward_list<Stop>& TransportCatalogue::GetStopsList() const {
+const std::deque<const Stop*>& TransportCatalogue::GetStopsList() const {
 	return stops_index_list_;
+}
+
+const spatial::StopIndex& TransportCatalogue::GetStopIndex() const {
+	return stop_index_;
+}
+
+const search::StopSearch& TransportCatalogue::GetStopSearch() const {
+	return stop_search_;
+}
+
+memory::Report TransportCatalogue::GetMemoryUsage() const {
+	memory::Report report;
+	report.Add("arena", arena_->GetMemoryUsage());
+	report.Add("stops", {memory::GetHeapBytes(stops_index_list_) + memory::GetHeapBytes(stops_), stops_.size()});
+	report.Add("buses", {memory::GetHeapBytes(buses_index_list_) + memory::GetHeapBytes(buses_), buses_.size()});
+	report.Add("bus_infos", {memory::GetHeapBytes(bus_infos_), bus_infos_.size()});
+	report.Add("route_lengths", {memory::GetHeapBytes(route_lengths_), route_lengths_.size()});
+	if (external_distances_) {
+		//Страницы внешней таблицы принадлежат кэшу файлов операционной системы
+		report.Add("external_distances", {0, external_distances_->GetSize()});
+	}
+	report.Add("stop_index", stop_index_.GetMemoryUsage());
+	report.Add("stop_search", stop_search_.GetMemoryUsage());
+	report.Add("bus_incidence", bus_incidence_.GetMemoryUsage());
+	return report;
+}
+
+void TransportCatalogue::ForEachDistance(const std::function<void(const Distance&)>& visitor) const {
+	//Расстояния в памяти и так занимают её целиком, поэтому их можно сгруппировать заранее
+	std::unordered_map<std::string_view, std::vector<std::pair<std::string_view, int>>> rows;
+	for (const auto& [stops, distance] : route_lengths_) {
+		rows[stops.first].emplace_back(stops.second, distance);
+	}
+	for (auto it = stops_index_list_.rbegin(); it != stops_index_list_.rend(); ++it) {
+		const std::string_view from = (*it)->name;
+		if (const auto row = rows.find(from); row != rows.end()) {
+			for (const auto& [to, distance] : row->second) {
+				visitor({from, to, distance});
+			}
+		}
+		if (external_distances_) {
+			external_distances_->ForEachFrom(from, [this, from, &visitor](std::string_view to, int distance) {
+				//Расстояния из памяти имеют приоритет над таблицей
+				if (!route_lengths_.count({from, to})) {
+					visitor({from, to, distance});
+				}
+			});
+		}
+	}
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
-#include <forward_list>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <string_view>
@@ -9,8 +12,26 @@
 #include <unordered_set>
 #include <vector>
 
+#include "arena.h"
+#include "bus_incidence.h"
 #include "domain.h"
 #include "geo.h"
+#include "memory_usage.h"
+#include "spatial_index.h"
+#include "stop_search.h"
+
+//Дорожные расстояния, которые справочник не держит в памяти, а читает по запросу
+//из внешнего хранилища (например, из отображённого файла, см. serialization::MapCatalogue).
+//Остановки задаются ключами справочника — его собственными string_view имён.
+class DistanceTable {
+public:
+	virtual ~DistanceTable() = default;
+	//Расстояние, заданное от from до to, если оно есть
+	virtual std::optional<int> Find(std::string_view from, std::string_view to) const = 0;
+	//Обходит расстояния, заданные от from, не собирая их в память
+	virtual void ForEachFrom(std::string_view from, const std::function<void(std::string_view to, int distance)>& visitor) const = 0;
+	virtual size_t GetSize() const = 0;
+};
 
 class TransportCatalogue {
 
@@ -30,29 +51,92 @@ class TransportCatalogue {
 	};
 
 public:
+	TransportCatalogue() = default;
+	//Копия разделяет с оригиналом неизменяемые записи в арене и копирует только индексы.
+	//Новые записи копии попадают в её собственную арену. Так строится следующая версия
+	//справочника, пока предыдущая продолжает отвечать на запросы
+	TransportCatalogue(const TransportCatalogue& other);
+	TransportCatalogue& operator=(const TransportCatalogue&) = delete;
+	TransportCatalogue(TransportCatalogue&&) = default;
+	TransportCatalogue& operator=(TransportCatalogue&&) = default;
+
+	//Пакетная загрузка: резервирует все индексы под объём данных и считает
+	//статистику маршрутов параллельно. Эквивалентна последовательным вызовам
+	//AddStop для всех остановок, затем AddDistance, AddBus и BuildIndexes.
+	void Load(const CatalogueData& data);
+	//То же, но имена из data не копируются: они должны указывать в storage,
+	//которое справочник держит живым до своего уничтожения (например, отображённый в память файл)
+	void Load(const CatalogueData& data, std::shared_ptr<const void> storage);
+	//То же, но основная часть расстояний не загружается, а читается из distances.
+	//Расстояния из data и из последующих Update дополняют таблицу и имеют приоритет над ней.
+	void Load(const CatalogueData& data, std::shared_ptr<const void> storage, std::shared_ptr<const DistanceTable> distances);
+	//Дополняет справочник новыми остановками, расстояниями и маршрутами.
+	//Расстояния могут относиться и к существующим остановкам: длины проходящих
+	//через них маршрутов пересчитываются. Если пакет переопределяет существующие
+	//остановки и маршруты, повторяет имена, ссылается на неизвестные остановки или задаёт
+	//отрицательное расстояние, бросается std::invalid_argument, и справочник не меняется.
+	CatalogueChanges Update(const CatalogueData& delta);
+	//Перестраивает вспомогательные индексы по текущему набору остановок и маршрутов.
+	//Load делает это сам, после одиночных AddStop и AddBus нужно вызвать явно.
+	void BuildIndexes();
 	void AddStop(const Stop& stop);
 	void AddBus(const Bus& bus);
 	void AddDistance(std::string_view stop_name, const std::vector<std::pair<std::string_view, int>>& stop_names);
 	int GetDistance(std::string_view from_stop_name, std::string_view to_stop_name) const;
 	BusInfo GetBusInfo(const std::string_view bus_name) const;
 	const Stop* FindStop(const std::string_view stop_name) const;
-	std::set<std::string_view> GetBusesOnStop(const std::string_view stop_name) const;
+	//Имена маршрутов через остановку по алфавиту; nullopt, если остановки нет
+	std::optional<std::vector<std::string_view>> GetBusesOnStop(const std::string_view stop_name) const;
+	//Маршруты, по которым можно доехать от одной остановки до другой без пересадки, по алфавиту;
+	//nullopt, если какой-то из остановок нет
+	std::optional<std::vector<std::string_view>> GetDirectBuses(std::string_view from_stop_name, std::string_view to_stop_name) const;
 	const std::map<std::string_view, const Bus*> GetBuses() const;
-	const std::forward_list<Stop>& GetStopsList() const;
+	const std::deque<const Stop*>& GetStopsList() const;
+	const spatial::StopIndex& GetStopIndex() const;
+	const search::StopSearch& GetStopSearch() const;
+	//Обходит все заданные дорожные расстояния, сгруппированные по начальной остановке
+	//в порядке добавления остановок; внутри группы порядок не определён.
+	//Внешняя таблица расстояний читается построчно и целиком в память не попадает
+	void ForEachDistance(const std::function<void(const Distance&)>& visitor) const;
+	//Память записей и индексов. Разделяемые с другими справочниками хранилища не учитываются
+	memory::Report GetMemoryUsage() const;
 
 
 private:
 
-	std::forward_list<Stop> stops_index_list_;
-	std::forward_list<Bus> buses_index_list_;
+	//Арена хранит записи остановок и маршрутов, их имена и списки остановок.
+	//Все string_view ключи индексов ниже указывают в неё или в чужие хранилища.
+	std::shared_ptr<memory::Arena> arena_ = std::make_shared<memory::Arena>();
+	//Чужие хранилища записей и имён: арены справочников-оригиналов, отображённые файлы
+	std::vector<std::shared_ptr<const void>> shared_storages_;
+	//Порядок обхода остановок (последняя добавленная — первая) сохранён
+	//прежним: от него зависит нумерация вершин графа маршрутизатора.
+	std::deque<const Stop*> stops_index_list_;
+	std::deque<const Bus*> buses_index_list_;
 	std::unordered_map<std::string_view, const Stop*> stops_;
 	std::unordered_map<std::string_view, const Bus*> buses_;
-	std::unordered_map<std::string_view, std::set<std::string_view>> buses_on_stop_;
-	//Кэш расстояний между остановками
-	std::unordered_map<std::pair<std::string_view, std::string_view>, double, PairHash, PairEqual> route_lengths_by_coords_;
+	//Статистика маршрутов считается один раз при добавлении автобуса
+	std::unordered_map<std::string_view, BusInfo> bus_infos_;
 	std::unordered_map<std::pair<std::string_view, std::string_view>, int, PairHash, PairEqual> route_lengths_;
+	std::shared_ptr<const DistanceTable> external_distances_;
+	spatial::StopIndex stop_index_;
+	search::StopSearch stop_search_;
+	incidence::BusIncidence bus_incidence_;
 
-	//Функция для вычисления длины маршрута. Вызывается при добавлении автобуса.
-	double ComputeRouteDistanceByCoords(const std::vector<std::string_view>& stops_on_route) const;
-	int ComputeRouteDistance(const std::vector<std::string_view>& stops_on_route) const;
+	//Проверяет пакет Update целиком до того, как справочник начнёт меняться
+	void CheckDelta(const CatalogueData& delta) const;
+	//Расстояние, заданное именно от from до to
+	std::optional<int> FindDistance(std::string_view from_stop_name, std::string_view to_stop_name) const;
+	//Переводит имена остановок маршрута в ключи справочника
+	std::vector<std::string_view> ResolveStops(std::span<const std::string_view> stop_names) const;
+	//Функции для вычисления длины маршрута. Вызываются при добавлении автобуса.
+	double ComputeRouteDistanceByCoords(std::span<const std::string_view> stops_on_route) const;
+	int ComputeRouteDistance(std::span<const std::string_view> stops_on_route) const;
+	BusInfo ComputeBusInfo(std::span<const std::string_view> stops_on_route) const;
+	//Добавляет записи без перестройки индексов
+	void LoadRecords(const CatalogueData& data, bool copy_names);
+	//Доводит индексы до состояния после Update, перестраивая только затронутые пакетом
+	void UpdateIndexes(const CatalogueChanges& changes);
+	void AddStopRecord(std::string_view stored_name, geo::Coordinates coordinates);
+	void AddBusRecord(std::string_view stored_name, bool is_circle, std::span<const std::string_view> stops_on_route, const BusInfo& info);
 };
\ No newline at end of file
@@ -1,62 +1,427 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_set>
+
+#include "mapped_file.h"
+#include "serialization.h"
 #include "transport_router.h"
 
 
 namespace routing {
 
+namespace {
+
+using namespace std::literals;
+
+constexpr char CACHE_MAGIC[8] = {'T', 'R', 'O', 'U', 'T', 'E', 'R', 'S'};
+constexpr uint32_t CACHE_VERSION = 1;
+//Особые значения prev_edge в файле: маршрута нет / маршрут есть, но без рёбер
+constexpr uint64_t NO_ROUTE = std::numeric_limits<uint64_t>::max();
+constexpr uint64_t NO_EDGE = NO_ROUTE - 1;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t content_hash;
+    uint64_t vertex_count;
+    uint64_t edge_count;
+};
+
+struct CacheEntry {
+    double weight;
+    uint64_t prev_edge;
+};
+
+//Ячейки читаются прямо из отображения, которое выровнено по странице
+static_assert(sizeof(CacheHeader) % alignof(CacheEntry) == 0);
+
+} // namespace
+
 TransportRouter::TransportRouter(const TransportCatalogue& db, const RoutingSettings& settings)
 : settings_(settings)
 , router_(std::nullopt)
 , db_(db)
 {   
-    graph::DirectedWeightedGraph<double> tmp_graph(std::distance(db_.GetStopsList().begin(), db_.GetStopsList().end()) * 2);
+    BuildGraph();
+    router_.emplace(graph::Router<double>(graph_));
+}
+
+TransportRouter::TransportRouter(const TransportCatalogue& db, const RoutingSettings& settings, const std::string& cache_path)
+: settings_(settings)
+, router_(std::nullopt)
+, db_(db)
+{
+    //Граф строится за линейное время и ссылается на имена справочника, поэтому
+    //его дешевле построить заново; из кэша берётся только таблица маршрутов
+    BuildGraph();
+    const uint64_t content_hash = ComputeContentHash();
+    routes_file_ = MapRoutesData(cache_path, content_hash);
+    if (!routes_file_) {
+        router_.emplace(graph_);
+        //Таблица уже посчитана в памяти: без файла-кэша маршрутизатор работает так же,
+        //только следующий запуск посчитает её заново
+        try {
+            SaveRoutesData(cache_path, content_hash);
+        } catch (const std::exception& e) {
+            std::cerr << "Router cache is not saved: "sv << e.what() << std::endl;
+        }
+    }
+}
+
+TransportRouter::TransportRouter(const TransportCatalogue& db, const TransportRouter& other)
+: settings_(other.settings_)
+, graph_(other.graph_)
+, router_(std::nullopt)
+, routes_file_(other.routes_file_)
+, stop_vertex_(other.stop_vertex_)
+, stop_edges_(other.stop_edges_)
+, bus_edges_(other.bus_edges_)
+, walk_edges_(other.walk_edges_)
+, bus_edge_ranges_(other.bus_edge_ranges_)
+, stop_wait_times_(other.stop_wait_times_)
+, bus_velocities_(other.bus_velocities_)
+, db_(db)
+{
+    if (other.router_) {
+        router_.emplace(graph_, other.router_->GetRoutesInternalData());
+    }
+}
+
+void TransportRouter::BuildGraph() {
+    graph::DirectedWeightedGraph<double> tmp_graph(db_.GetStopsList().size() * 2);
     graph_ = std::move(tmp_graph);
+    const std::vector<const Stop*> stops(db_.GetStopsList().begin(), db_.GetStopsList().end());
+    std::vector<const Bus*> buses;
+    for (const auto& [bus_name, bus] : db_.GetBuses()) {
+        buses.push_back(bus);
+    }
+    stop_wait_times_.clear();
+    bus_velocities_.clear();
+    ExtendProfiles(stops, {});
     AddStops();
-    AddBuses();
-    router_.emplace(graph::Router<double>(graph_));
+    AddBuses(buses);
+    AddWalkTransfers();
+}
+
+void TransportRouter::ExtendProfiles(std::span<const Stop* const> stops, std::span<const Bus* const> buses) {
+    for (const Stop* stop : stops) {
+        const auto it = settings_.stop_wait_times.find(stop->name);
+        stop_wait_times_.push_back(it != settings_.stop_wait_times.end() ? it->second : settings_.bus_wait_time);
+    }
+    for (const Bus* bus : buses) {
+        const auto it = settings_.bus_velocities.find(bus->name);
+        bus_velocities_.push_back(it != settings_.bus_velocities.end() ? it->second : settings_.bus_velocity);
+    }
+}
+
+void TransportRouter::Update(const CatalogueChanges& changes) {
+    if (!router_) {
+        //Дополнять можно только таблицу в памяти; граф ещё прежний, и ей соответствует
+        router_.emplace(graph_, ReadRoutesData());
+        routes_file_.reset();
+    }
+    const size_t old_edge_count = graph_.GetEdgeCount();
+    std::vector<graph::EdgeId> decreased_edges;
+    bool weights_increased = false;
+    for (const Bus* bus : changes.changed_buses) {
+        weights_increased |= !UpdateBusWeights(*bus, decreased_edges);
+    }
+    ExtendProfiles(changes.added_stops, {});
+    for (const Stop* stop : changes.added_stops) {
+        const graph::VertexId begin = graph_.AddVertex();
+        graph_.AddVertex();
+        AddStop(*stop, begin);
+    }
+    AddBuses(changes.added_buses);
+    if (settings_.walk_transfer_distance > 0) {
+        //Пересадки между двумя новыми остановками добавятся при обходе каждой из них
+        const std::unordered_set<const Stop*> added_stops(changes.added_stops.begin(), changes.added_stops.end());
+        for (const Stop* stop : changes.added_stops) {
+            for (const auto& [neighbour, distance] : db_.GetStopIndex().FindWithinRadius(stop->coordinates, settings_.walk_transfer_distance)) {
+                if (neighbour == stop) {
+                    continue;
+                }
+                AddWalkEdge(*stop, *neighbour, distance);
+                if (!added_stops.count(neighbour)) {
+                    AddWalkEdge(*neighbour, *stop, distance);
+                }
+            }
+        }
+    }
+    //Обход одного ребра стоит O(V^2), полный пересчёт — O(V^3)
+    const size_t relaxed_edges = decreased_edges.size() + graph_.GetEdgeCount() - old_edge_count;
+    if (weights_increased || relaxed_edges >= graph_.GetVertexCount()) {
+        router_.emplace(graph_);
+    } else {
+        router_->Update(decreased_edges);
+    }
 }
 
 void TransportRouter::AddStops(){
     graph::VertexId vertex_id = 0;
-    for (const auto& stop: db_.GetStopsList()){
-        stop_vertex_[stop.name] = {vertex_id, vertex_id + 1};
-        graph::EdgeId id = graph_.AddEdge({vertex_id, vertex_id + 1, static_cast<double>(settings_.bus_wait_time)});
-        stop_edges_[id] = { stop.name, settings_.bus_wait_time };
+    for (const Stop* stop: db_.GetStopsList()){
+        AddStop(*stop, vertex_id);
         vertex_id += 2;
     }
 }
 
-void TransportRouter::AddBuses() {
-    for (const auto& [bus_name, bus]: db_.GetBuses()){
-        size_t stops_count = bus->stops.size();
-        for (size_t i = 0; i < stops_count; ++i) {
-            for (size_t j = i + 1; j < stops_count; ++j) {
-                int total_distance = 0;
-                for (size_t k = i; k < j; ++k) {
-                    total_distance += db_.GetDistance(bus->stops[k], bus->stops[k + 1]);
-                }
-                double total_travel_time = total_distance * 60.0 / (settings_.bus_velocity * 1000);
-                graph::EdgeId id = graph_.AddEdge({ stop_vertex_[bus->stops[i]].end, stop_vertex_[bus->stops[j]].begin, total_travel_time});
-                bus_edges_[id] = { bus->name, static_cast<int>(j - i), total_travel_time};
+void TransportRouter::AddStop(const Stop& stop, graph::VertexId begin) {
+    stop_vertex_[stop.name] = {begin, begin + 1};
+    const double wait_time = stop_wait_times_[begin / 2];
+    graph::EdgeId id = graph_.AddEdge({begin, begin + 1, wait_time});
+    stop_edges_[id] = { stop.name, wait_time };
+}
+
+void TransportRouter::AddBuses(std::span<const Bus* const> buses) {
+    const size_t first_id = bus_velocities_.size();
+    ExtendProfiles({}, buses);
+    for (size_t i = 0; i < buses.size(); ++i) {
+        AddBus(*buses[i], first_id + i);
+    }
+}
+
+template <typename Func>
+void TransportRouter::ForEachBusEdge(const Bus& bus, size_t bus_id, Func func) const {
+    const double velocity = bus_velocities_[bus_id];
+    size_t stops_count = bus.stops.size();
+    for (size_t i = 0; i < stops_count; ++i) {
+        for (size_t j = i + 1; j < stops_count; ++j) {
+            int total_distance = 0;
+            for (size_t k = i; k < j; ++k) {
+                total_distance += db_.GetDistance(bus.stops[k], bus.stops[k + 1]);
+            }
+            double total_travel_time = total_distance * 60.0 / (velocity * 1000);
+            func(stop_vertex_.at(bus.stops[i]).end, stop_vertex_.at(bus.stops[j]).begin, static_cast<int>(j - i), total_travel_time);
+        }
+    }
+}
+
+void TransportRouter::AddBus(const Bus& bus, size_t bus_id) {
+    bus_edge_ranges_[bus.name] = {bus_id, graph_.GetEdgeCount()};
+    ForEachBusEdge(bus, bus_id, [this, &bus](graph::VertexId from, graph::VertexId to, int span_count, double time) {
+        graph::EdgeId id = graph_.AddEdge({from, to, time});
+        bus_edges_[id] = {bus.name, span_count, time};
+    });
+}
+
+bool TransportRouter::UpdateBusWeights(const Bus& bus, std::vector<graph::EdgeId>& decreased_edges) {
+    const BusEdges range = bus_edge_ranges_.at(bus.name);
+    graph::EdgeId id = range.first_edge;
+    bool increased = false;
+    ForEachBusEdge(bus, range.bus_id, [&](graph::VertexId, graph::VertexId, int, double time) {
+        const double old_time = graph_.GetEdge(id).weight;
+        if (time < old_time) {
+            decreased_edges.push_back(id);
+        } else if (time > old_time) {
+            increased = true;
+        }
+        graph_.SetWeight(id, time);
+        bus_edges_.at(id).time = time;
+        ++id;
+    });
+    return !increased;
+}
+
+void TransportRouter::AddWalkTransfers() {
+    if (settings_.walk_transfer_distance <= 0) {
+        return;
+    }
+    //Соседей каждой остановки ищем через сеточный индекс справочника, а не перебором всех пар
+    for (const Stop* stop : db_.GetStopsList()) {
+        for (const auto& [neighbour, distance] : db_.GetStopIndex().FindWithinRadius(stop->coordinates, settings_.walk_transfer_distance)) {
+            if (neighbour != stop) {
+                AddWalkEdge(*stop, *neighbour, distance);
+            }
+        }
+    }
+}
+
+void TransportRouter::AddWalkEdge(const Stop& from, const Stop& to, double distance) {
+    const double meters_per_minute = settings_.walk_velocity * 1000 / 60.0;
+    const double time = distance / meters_per_minute;
+    graph::EdgeId id = graph_.AddEdge({ stop_vertex_.at(from.name).begin, stop_vertex_.at(to.name).begin, time });
+    walk_edges_[id] = { from.name, to.name, time };
+}
+
+uint64_t TransportRouter::ComputeContentHash() const {
+    serialization::Hasher hasher;
+    hasher.Add(serialization::ComputeCatalogueHash(db_));
+    hasher.Add(settings_.bus_wait_time);
+    hasher.Add(settings_.bus_velocity);
+    hasher.Add(settings_.walk_transfer_distance);
+    hasher.Add(settings_.walk_velocity);
+    for (const auto* profile : {&settings_.bus_velocities, &settings_.stop_wait_times}) {
+        hasher.Add(profile->size());
+        for (const auto& [name, value] : *profile) {
+            hasher.Add(name);
+            hasher.Add(value);
+        }
+    }
+    return hasher.GetHash();
+}
+
+std::unique_ptr<memory::MappedFile> TransportRouter::MapRoutesData(const std::string& path, uint64_t content_hash) const {
+    std::unique_ptr<memory::MappedFile> file;
+    try {
+        file = std::make_unique<memory::MappedFile>(path);
+    } catch (const std::runtime_error&) {
+        return nullptr; //Кэша ещё нет
+    }
+    const std::span<const std::byte> bytes = file->GetData();
+    const size_t vertex_count = graph_.GetVertexCount();
+
+    CacheHeader header{};
+    if (bytes.size() < sizeof(header)) {
+        return nullptr;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+        || header.version != CACHE_VERSION
+        || header.content_hash != content_hash
+        || header.vertex_count != vertex_count
+        || header.edge_count != graph_.GetEdgeCount()
+        || bytes.size() != sizeof(header) + vertex_count * vertex_count * sizeof(CacheEntry)) {
+        return nullptr;
+    }
+    //Маршрут читает по ячейке на ребро из одной строки таблицы, а строки запросов случайны
+    file->AdviseRandomAccess(sizeof(header), bytes.size() - sizeof(header));
+    return file;
+}
+
+TransportRouter::RoutesData TransportRouter::ReadRoutesData() const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    RoutesData routes_data(vertex_count, std::vector<std::optional<RouteData>>(vertex_count));
+    for (graph::VertexId from = 0; from < vertex_count; ++from) {
+        for (graph::VertexId to = 0; to < vertex_count; ++to) {
+            routes_data[from][to] = GetRouteData(from, to);
+        }
+    }
+    return routes_data;
+}
+
+std::optional<TransportRouter::RouteData> TransportRouter::GetRouteData(graph::VertexId from, graph::VertexId to) const {
+    if (router_) {
+        return router_->GetRoutesInternalData()[from][to];
+    }
+    const auto* entries = reinterpret_cast<const CacheEntry*>(routes_file_->GetData().data() + sizeof(CacheHeader));
+    const CacheEntry& entry = entries[from * graph_.GetVertexCount() + to];
+    if (entry.prev_edge == NO_ROUTE) {
+        return std::nullopt;
+    }
+    if (entry.prev_edge == NO_EDGE) {
+        return RouteData{entry.weight, std::nullopt};
+    }
+    //Хэш содержимого совпал, поэтому такое возможно только при повреждённом файле
+    if (entry.prev_edge >= graph_.GetEdgeCount()) {
+        throw std::runtime_error("Corrupted router cache: edge "s + std::to_string(entry.prev_edge) + " does not exist"s);
+    }
+    return RouteData{entry.weight, entry.prev_edge};
+}
+
+void TransportRouter::SaveRoutesData(const std::string& path, uint64_t content_hash) const {
+    const RoutesData& routes_data = router_->GetRoutesInternalData();
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.content_hash = content_hash;
+    header.vertex_count = graph_.GetVertexCount();
+    header.edge_count = graph_.GetEdgeCount();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to open "s + path + " for writing"s);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<CacheEntry> row;
+    for (const auto& routes_from : routes_data) {
+        row.clear();
+        for (const auto& route : routes_from) {
+            if (!route) {
+                row.push_back({0, NO_ROUTE});
+            } else {
+                row.push_back({route->weight, route->prev_edge ? *route->prev_edge : NO_EDGE});
             }
         }
+        out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(CacheEntry)));
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write "s + path);
     }
 }
 
-std::pair<double, std::vector<std::variant<StopEdge, BusEdge>>> TransportRouter::BuildRoute(std::string_view from, std::string_view to) const {
-    std::optional<graph::Router<double>::RouteInfo> route_info = router_.value().BuildRoute(stop_vertex_.at(from).begin, stop_vertex_.at(to).begin);
-    if (!route_info.has_value()) {
+std::pair<double, std::vector<RouteItem>> TransportRouter::BuildRoute(std::string_view from, std::string_view to) const {
+    const auto from_it = stop_vertex_.find(from);
+    const auto to_it = stop_vertex_.find(to);
+    if (from_it == stop_vertex_.end() || to_it == stop_vertex_.end()) {
         return {-1, {}};
     }
-    std::vector<std::variant<StopEdge, BusEdge>> items;
-    items.reserve(route_info.value().edges.size());
-    for (graph::EdgeId edge_id : route_info.value().edges) {
+    const graph::VertexId from_vertex = from_it->second.begin;
+    const std::optional<RouteData> route_data = GetRouteData(from_vertex, to_it->second.begin);
+    if (!route_data) {
+        return {-1, {}};
+    }
+    //Как graph::Router::BuildRoute: рёбра восстанавливаются с конца по prev_edge
+    std::vector<graph::EdgeId> edges;
+    for (std::optional<graph::EdgeId> edge_id = route_data->prev_edge; edge_id;) {
+        edges.push_back(*edge_id);
+        //В целой таблице начало ребра маршрута достижимо из from, а путь по prev_edge конечен
+        const std::optional<RouteData> prev = GetRouteData(from_vertex, graph_.GetEdge(*edge_id).from);
+        if (!prev || edges.size() > graph_.GetEdgeCount()) {
+            throw std::runtime_error("Corrupted router cache: broken route from vertex "s + std::to_string(from_vertex));
+        }
+        edge_id = prev->prev_edge;
+    }
+    std::vector<RouteItem> items;
+    items.reserve(edges.size());
+    for (auto it = edges.rbegin(); it != edges.rend(); ++it) {
+        const graph::EdgeId edge_id = *it;
         if (stop_edges_.count(edge_id)) {
             items.push_back(stop_edges_.at(edge_id));
-        } else {
+        } else if (bus_edges_.count(edge_id)) {
             items.push_back(bus_edges_.at(edge_id));
+        } else {
+            items.push_back(walk_edges_.at(edge_id));
         }
     }
-    return { route_info.value().weight, items };
+    return { route_data->weight, items };
+}
+
+memory::Report TransportRouter::GetMemoryUsage() const {
+    memory::Report report;
+    report.Add("graph", graph_.GetMemoryUsage());
+    if (router_) {
+        report.Add("routes", router_->GetMemoryUsage());
+    } else {
+        //Страницы отображённой таблицы принадлежат кэшу файлов операционной системы
+        const size_t vertex_count = graph_.GetVertexCount();
+        report.Add("routes", {0, vertex_count * vertex_count});
+    }
+    report.Add("stop_vertices", {memory::GetHeapBytes(stop_vertex_), stop_vertex_.size()});
+    report.Add("profiles", {
+        memory::GetHeapBytes(stop_wait_times_) + memory::GetHeapBytes(bus_velocities_),
+        stop_wait_times_.size() + bus_velocities_.size()});
+    report.Add("edge_items", {
+        memory::GetHeapBytes(stop_edges_) + memory::GetHeapBytes(bus_edges_) + memory::GetHeapBytes(walk_edges_)
+            + memory::GetHeapBytes(bus_edge_ranges_),
+        stop_edges_.size() + bus_edges_.size() + walk_edges_.size()});
+    return report;
+}
+
+std::optional<double> TransportRouter::GetRouteTime(std::string_view from, std::string_view to) const {
+    const auto from_it = stop_vertex_.find(from);
+    const auto to_it = stop_vertex_.find(to);
+    if (from_it == stop_vertex_.end() || to_it == stop_vertex_.end()) {
+        return std::nullopt;
+    }
+    const std::optional<RouteData> route_data = GetRouteData(from_it->second.begin, to_it->second.begin);
+    if (!route_data) {
+        return std::nullopt;
+    }
+    return route_data->weight;
 }
 
 } //namespace routing
\ No newline at end of file
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <functional>
 #include <unordered_map>
-#include <forward_list>
 #include <map>
+#include <memory>
 #include <optional>
+#include <span>
+#include <string>
 #include <variant>
+#include <vector>
 
 #include "graph.h"
+#include "mapped_file.h"
 #include "router.h"
 #include "domain.h"
 #include "transport_catalogue.h"
@@ -16,11 +21,18 @@ namespace routing {
 struct RoutingSettings {
     int bus_wait_time = 6;
     int bus_velocity = 40;
+    //Пешие пересадки между остановками не дальше walk_transfer_distance метров, 0 — отключены
+    double walk_transfer_distance = 0;
+    double walk_velocity = 5;
+    //Профили весов: скорости отдельных маршрутов (км/ч) и ожидание на отдельных остановках (мин)
+    //вместо общих bus_velocity и bus_wait_time. Имена, которых нет в справочнике, пропускаются
+    std::map<std::string, double, std::less<>> bus_velocities;
+    std::map<std::string, double, std::less<>> stop_wait_times;
 };
 
 struct StopEdge {
     std::string_view stop_name;
-    int time;
+    double time;
 };
 
 struct BusEdge {
@@ -29,11 +41,40 @@ struct BusEdge {
     double time;
 };
 
+struct WalkEdge {
+    std::string_view from;
+    std::string_view to;
+    double time;
+};
+
+using RouteItem = std::variant<StopEdge, BusEdge, WalkEdge>;
+
 class TransportRouter {
 public:
 
     explicit TransportRouter(const TransportCatalogue& db, const RoutingSettings& settings);
-    std::pair<double, std::vector<std::variant<StopEdge, BusEdge>>> BuildRoute(std::string_view from, std::string_view to) const;
+    //Использует файл-кэш таблицы маршрутов. Если файл посчитан для того же содержимого справочника
+    //и тех же настроек, он отображается в память и запросы читают таблицу прямо из него,
+    //иначе таблица считается заново и файл перезаписывается
+    TransportRouter(const TransportCatalogue& db, const RoutingSettings& settings, const std::string& cache_path);
+    //Копия other для справочника db — копии справочника other (записи и имена у них общие).
+    //Граф и таблица маршрутов копируются, отображённый файл-кэш разделяется
+    TransportRouter(const TransportCatalogue& db, const TransportRouter& other);
+    //Таблица маршрутов ссылается на граф внутри объекта
+    TransportRouter(const TransportRouter&) = delete;
+    TransportRouter& operator=(const TransportRouter&) = delete;
+    //Время -1, если маршрута нет или остановка неизвестна
+    std::pair<double, std::vector<RouteItem>> BuildRoute(std::string_view from, std::string_view to) const;
+    //Только время маршрута, без восстановления рёбер. nullopt, если маршрута нет или остановка неизвестна
+    std::optional<double> GetRouteTime(std::string_view from, std::string_view to) const;
+    //Учитывает изменения справочника, на который ссылается маршрутизатор. Граф дополняется
+    //новыми рёбрами, а веса рёбер маршрутов с изменённой длиной пересчитываются на месте.
+    //Таблица маршрутов дополняется только через новые и подешевевшие рёбра (таблица из файла-кэша
+    //для этого сначала читается в память). Если какое-то ребро подорожало или таких рёбер
+    //не меньше, чем вершин, таблица считается заново: это не дольше обхода всех рёбер
+    void Update(const CatalogueChanges& changes);
+    //Граф, таблица маршрутов и описания рёбер
+    memory::Report GetMemoryUsage() const;
 
 private:
     struct StopVertex {
@@ -41,16 +82,54 @@ private:
         graph::VertexId end;
     };
 
+    //Рёбра маршрута добавляются подряд, начиная с first_edge
+    struct BusEdges {
+        size_t bus_id;
+        graph::EdgeId first_edge;
+    };
+
     RoutingSettings settings_;
     graph::DirectedWeightedGraph<double> graph_;
+    //Таблица маршрутов: либо посчитана в router_, либо отображена из файла-кэша в routes_file_
     std::optional<graph::Router<double>> router_;
+    std::shared_ptr<const memory::MappedFile> routes_file_;
     std::unordered_map<std::string_view, StopVertex>  stop_vertex_;
     std::unordered_map<graph::EdgeId, StopEdge> stop_edges_;
     std::unordered_map<graph::EdgeId, BusEdge> bus_edges_;
+    std::unordered_map<graph::EdgeId, WalkEdge> walk_edges_;
+    std::unordered_map<std::string_view, BusEdges> bus_edge_ranges_;
+    //Профили весов, разрешённые по номерам: ожидание — по номеру остановки (вершина begin / 2),
+    //скорость — по номеру маршрута в порядке добавления в граф. Граф один при любых профилях
+    std::vector<double> stop_wait_times_;
+    std::vector<double> bus_velocities_;
     const TransportCatalogue& db_;
 
+    using RouteData = graph::Router<double>::RouteInternalData;
+    using RoutesData = graph::Router<double>::RoutesInternalData;
+
+    void BuildGraph();
+    //Дописывает в профили веса новых остановок и маршрутов
+    void ExtendProfiles(std::span<const Stop* const> stops, std::span<const Bus* const> buses);
     void AddStops();
-    void AddBuses();
+    void AddStop(const Stop& stop, graph::VertexId begin);
+    void AddBuses(std::span<const Bus* const> buses);
+    void AddBus(const Bus& bus, size_t bus_id);
+    //Вызывает func(from, to, span_count, time) для рёбер маршрута в порядке их добавления
+    template <typename Func>
+    void ForEachBusEdge(const Bus& bus, size_t bus_id, Func func) const;
+    //Пересчитывает веса рёбер маршрута; подешевевшие рёбра дописывает в decreased_edges.
+    //Возвращает false, если какое-то ребро подорожало
+    bool UpdateBusWeights(const Bus& bus, std::vector<graph::EdgeId>& decreased_edges);
+    void AddWalkTransfers();
+    void AddWalkEdge(const Stop& from, const Stop& to, double distance);
+    uint64_t ComputeContentHash() const;
+    //Отображает файл-кэш, если он подходит к графу и content_hash
+    std::unique_ptr<memory::MappedFile> MapRoutesData(const std::string& path, uint64_t content_hash) const;
+    //Копия отображённой таблицы для маршрутизатора, который будет её дополнять
+    RoutesData ReadRoutesData() const;
+    void SaveRoutesData(const std::string& path, uint64_t content_hash) const;
+    //Ячейка таблицы маршрутов из router_ или из файла-кэша
+    std::optional<RouteData> GetRouteData(graph::VertexId from, graph::VertexId to) const;
 };
 
 } //namespace routing
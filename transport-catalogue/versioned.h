@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace versioning {
+
+/*
+ * Хранилище версий неизменяемого объекта (MVCC).
+ * Читатель получает снимок текущей версии через Acquire и пользуется им сколько угодно:
+ * снимок не изменится и не будет удалён, пока на него есть ссылки.
+ * Писатель строит новую версию отдельно и атомарно публикует её, не останавливая читателей.
+ * Писатели выполняются по очереди.
+ */
+template <typename T>
+class Versioned {
+public:
+    using Snapshot = std::shared_ptr<const T>;
+
+    explicit Versioned(Snapshot initial)
+        : current_(std::move(initial)) {
+    }
+
+    Snapshot Acquire() const {
+        return Load();
+    }
+
+    void Publish(Snapshot next) {
+        std::lock_guard guard(write_mutex_);
+        Store(std::move(next));
+    }
+
+    // Строит следующую версию по текущей: make_next(const T&) возвращает std::shared_ptr<const T>.
+    // Если make_next бросает исключение, опубликованной остаётся прежняя версия
+    template <typename MakeNext>
+    Snapshot Update(MakeNext make_next) {
+        std::lock_guard guard(write_mutex_);
+        Snapshot next = make_next(*Load());
+        Store(next);
+        return next;
+    }
+
+private:
+    // std::atomic<std::shared_ptr> есть только с libstdc++ 12, поэтому указатель читается
+    // и заменяется атомарными функциями для std::shared_ptr, которые есть и в GCC 11
+    Snapshot current_;
+
+    Snapshot Load() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    void Store(Snapshot next) {
+        std::atomic_store_explicit(&current_, std::move(next), std::memory_order_release);
+    }
+
+    std::mutex write_mutex_;
+};
+
+} // namespace versioning